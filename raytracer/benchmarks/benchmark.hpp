@@ -0,0 +1,37 @@
+#ifndef __BENCHMARK_HPP__
+#define __BENCHMARK_HPP__
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace benchmark {
+
+    // Keeps the optimizer from discarding a result without adding a store to
+    // the measured loop.
+    template <typename T>
+    inline void doNotOptimize(T const &value)
+    {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    // Runs f() `iterations` times and prints the average time per call.
+    // Returns the average in nanoseconds so callers can compute ratios.
+    template <typename F>
+    double measure(const std::string &name, std::size_t iterations, F &&f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i)
+            f(i);
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        double perCall = elapsed / iterations;
+        std::cout << std::left << std::setw(40) << name << std::right << std::setw(10) << std::fixed << std::setprecision(2) << perCall << " ns/op" << std::endl;
+        return perCall;
+    }
+
+} // namespace benchmark
+
+#endif // __BENCHMARK_HPP__
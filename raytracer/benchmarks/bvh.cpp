@@ -0,0 +1,58 @@
+#include "raytracer.hpp"
+
+#include "benchmark.hpp"
+
+// Compares the KDTree and the BVH on an OBJ model (teapot.obj by default):
+// construction time and primary rays per second through the snippet 12 camera.
+
+using namespace raytracer;
+
+static std::vector<Shape *> loadTriangles(const OBJFileParser &parser)
+{
+    std::vector<Shape *> shapes;
+    for (auto &face : parser.faces)
+        shapes.push_back(new Triangle(face));
+    return shapes;
+}
+
+template <typename Build>
+static void run(const std::string &name, const OBJFileParser &parser, int size, Build &&build)
+{
+    std::vector<Shape *> shapes = loadTriangles(parser);
+
+    auto start = std::chrono::steady_clock::now();
+    Shape *tree = build(shapes);
+    double buildTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    Camera camera(size, size, M_PI / 3);
+    camera.setTransform(Matrix4::viewTransform(Point(0, 3.0, -5.0), Point(0, 0, 0), Vector(0, 1, 0)));
+
+    std::size_t hits = 0;
+    start = std::chrono::steady_clock::now();
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            if (tree->intersect(camera.rayForPixel(x, y)).hit() != nullptr)
+                hits++;
+        }
+    }
+    double traceTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << std::left << std::setw(8) << name << " build " << std::right << std::setw(8) << std::fixed << std::setprecision(2) << buildTime << " ms, "
+              << std::setw(10) << std::setprecision(0) << (size * size) / traceTime << " rays/s (" << hits << " hits)" << std::endl;
+
+    delete tree;
+}
+
+int main(int argc, char **argv)
+{
+    std::string path = argc > 1 ? argv[1] : "teapot.obj";
+    int size = argc > 2 ? std::stoi(argv[2]) : 128;
+
+    OBJFileParser parser = OBJFileParser::ParseFile(path);
+    std::cout << path << ": " << parser.faces.size() << " triangles, " << size << "x" << size << " primary rays" << std::endl;
+
+    run("KDTree", parser, size, [](std::vector<Shape *> &shapes) { return new KDTree(shapes, 8); });
+    run("BVH", parser, size, [](std::vector<Shape *> &shapes) { return new BVH(shapes); });
+
+    return 0;
+}
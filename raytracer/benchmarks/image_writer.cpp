@@ -0,0 +1,66 @@
+#include "raytracer.hpp"
+
+#include "benchmark.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// Encoding throughput of the image writers on a 4K gradient, against the
+// text P3 output of Canvas::toPPM. Output goes to the given path, /dev/null
+// by default so the disk does not enter the measurement.
+
+using namespace raytracer;
+
+static void report(const std::string &name, std::size_t bytes, double seconds)
+{
+    std::cout << std::left << std::setw(20) << name << std::right << std::setw(10) << std::fixed << std::setprecision(1)
+              << bytes / 1e6 << " MB " << std::setw(8) << seconds * 1e3 << " ms " << std::setw(8) << bytes / 1e6 / seconds << " MB/s" << std::endl;
+}
+
+template <typename F>
+static void run(const std::string &name, int repeat, F &&write)
+{
+    std::size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; ++i)
+        bytes = write();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / repeat;
+    report(name, bytes, seconds);
+}
+
+int main(int argc, char **argv)
+{
+    std::string path = argc > 1 ? argv[1] : "/dev/null";
+    int width = argc > 2 ? std::stoi(argv[2]) : 3840;
+    int height = argc > 3 ? std::stoi(argv[3]) : 2160;
+    int repeat = 3;
+
+    for (auto format : {PixelFormat::RGB32F, PixelFormat::RGB64F}) {
+        Canvas canvas(width, height, format);
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                canvas.writePixel(x, y, Color(static_cast<double>(x) / width, static_cast<double>(y) / height, 0.5));
+        std::cout << width << "x" << height << (format == PixelFormat::RGB32F ? " RGB32F" : " RGB64F") << " -> " << path << std::endl;
+
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            std::cerr << "cannot open " << path << std::endl;
+            return 1;
+        }
+        auto rewind = [&] {
+            ::lseek(fd, 0, SEEK_SET);
+            return fd;
+        };
+
+        run("P3 (toPPM)", 1, [&] {
+            std::string ppm = canvas.toPPM();
+            std::size_t n = ::write(rewind(), ppm.data(), ppm.size());
+            return n;
+        });
+        run("P6", repeat, [&] { return ImageWriter::WritePPM(canvas, rewind()); });
+        run("PFM", repeat, [&] { return ImageWriter::WritePFM(canvas, rewind()); });
+        run("PNG (stored)", repeat, [&] { return ImageWriter::WritePNG(canvas, rewind()); });
+        ::close(fd);
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include "raytracer.hpp"
+
+#include "benchmark.hpp"
+
+// Compares the old priority_queue + std::function sort with the in-place
+// insertion sort and the sorted-insert merge, on the intersection lists the
+// snippet 12 scene (floor plane + teapot BVH) produces for its primary rays.
+
+using namespace raytracer;
+
+// The previous Intersections::sort, kept here as the baseline.
+static void legacySort(std::vector<Intersection> &xs)
+{
+    typedef std::function<bool(const Intersection &, const Intersection &)> Compare;
+
+    std::priority_queue<Intersection, std::vector<Intersection>, Compare> pq(
+        [](const Intersection &a, const Intersection &b) {
+            return a.t() > b.t();
+        });
+
+    while (xs.empty() == false) {
+        pq.push(xs.back());
+        xs.pop_back();
+    }
+
+    while (pq.empty() == false) {
+        xs.push_back(pq.top());
+        pq.pop();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string path = argc > 1 ? argv[1] : "teapot.obj";
+    int size = argc > 2 ? std::stoi(argv[2]) : 128;
+
+    Plane floor;
+    std::vector<Shape *> triangles;
+    OBJFileParser parser = OBJFileParser::ParseFile(path);
+    for (auto &face : parser.faces)
+        triangles.push_back(new Triangle(face));
+    BVH teapot(triangles);
+
+    Camera camera(size, size, M_PI / 3);
+    camera.setTransform(Matrix4::viewTransform(Point(0, 3.0, -5.0), Point(0, 0, 0), Vector(0, 1, 0)));
+
+    // Unsorted per-ray lists, as World::intersect sees them before sorting.
+    std::vector<std::vector<Intersection>> lists;
+    std::size_t total = 0, longest = 0;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            Ray r = camera.rayForPixel(x, y);
+            std::vector<Intersection> xs;
+            for (const Shape *shape : {static_cast<const Shape *>(&floor), static_cast<const Shape *>(&teapot)}) {
+                Intersections hits = shape->intersect(r);
+                for (std::size_t i = 0; i < hits.count(); ++i)
+                    xs.push_back(hits[i]);
+            }
+            total += xs.size();
+            longest = std::max(longest, xs.size());
+            lists.push_back(std::move(xs));
+        }
+    }
+    std::cout << path << ": " << lists.size() << " rays, " << std::setprecision(2) << std::fixed << static_cast<double>(total) / lists.size()
+              << " intersections per ray on average, " << longest << " at most" << std::endl;
+
+    constexpr std::size_t ITERATIONS = 2000000;
+    auto at = [&](std::size_t i) -> const std::vector<Intersection> & { return lists[i % lists.size()]; };
+
+    double legacy = benchmark::measure("priority_queue + std::function", ITERATIONS, [&](std::size_t i) {
+        std::vector<Intersection> xs = at(i);
+        legacySort(xs);
+        benchmark::doNotOptimize(xs);
+    });
+    double sorted = benchmark::measure("Intersections::sort", ITERATIONS, [&](std::size_t i) {
+        Intersections xs(at(i));
+        xs.sort();
+        benchmark::doNotOptimize(xs);
+    });
+    double merged = benchmark::measure("Intersections::insert", ITERATIONS, [&](std::size_t i) {
+        Intersections xs;
+        for (const auto &x : at(i))
+            xs.insert(x);
+        benchmark::doNotOptimize(xs);
+    });
+
+    std::cout << "speedup: sort " << legacy / sorted << "x, insert " << legacy / merged << "x" << std::endl;
+    return 0;
+}
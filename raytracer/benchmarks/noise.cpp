@@ -0,0 +1,124 @@
+#include "raytracer.hpp"
+
+#include "benchmark.hpp"
+
+#include <numeric>
+#include <random>
+
+// Perlin pattern samples per second with the previous PerlinPattern, which
+// built and shuffled a permutation on every call, against PerlinNoise with
+// its constant table, one point and four points at a time. Build with
+// RAYTRACER_SIMD=SSE or AVX2 to compare the 4-wide path on SIMD kernels.
+
+using namespace raytracer;
+
+// The previous PerlinPattern::patternAt, kept here as the baseline.
+class LegacyPerlinPattern : public APattern {
+public:
+    LegacyPerlinPattern(const Color &a, const Color &b)
+        : APattern(a, b)
+    {
+    }
+
+    Color patternAt(const Point &point) const override
+    {
+        std::vector<int> p(256);
+        std::iota(p.begin(), p.end(), 0);
+        std::shuffle(p.begin(), p.end(), std::default_random_engine());
+        p.insert(p.end(), p.begin(), p.end());
+
+        int X = static_cast<int>(std::floor(point.x)) & 255;
+        int Y = static_cast<int>(std::floor(point.y)) & 255;
+        int Z = static_cast<int>(std::floor(point.z)) & 255;
+        double x = point.x - std::floor(point.x);
+        double y = point.y - std::floor(point.y);
+        double z = point.z - std::floor(point.z);
+        double u = fade(x), v = fade(y), w = fade(z);
+
+        int A = p[X] + Y, AA = p[A] + Z, AB = p[A + 1] + Z;
+        int B = p[X + 1] + Y, BA = p[B] + Z, BB = p[B + 1] + Z;
+        double n = lerp(w, lerp(v, lerp(u, grad(p[AA], x, y, z), grad(p[BA], x - 1, y, z)), lerp(u, grad(p[AB], x, y - 1, z), grad(p[BB], x - 1, y - 1, z))),
+                        lerp(v, lerp(u, grad(p[AA + 1], x, y, z - 1), grad(p[BA + 1], x - 1, y, z - 1)), lerp(u, grad(p[AB + 1], x, y - 1, z - 1), grad(p[BB + 1], x - 1, y - 1, z - 1))));
+        return a + (b - a) * n;
+    }
+
+private:
+    static double fade(double t) { return t * t * t * (t * (t * 6 - 15) + 10); }
+    static double lerp(double t, double a, double b) { return a + t * (b - a); }
+    static double grad(int hash, double x, double y, double z)
+    {
+        int h = hash & 15;
+        double u = h < 8 ? x : y;
+        double v = h < 4 ? y : h == 12 || h == 14 ? x : z;
+        return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
+    }
+};
+
+static void rate(const std::string &name, double nanoseconds)
+{
+    std::cout << std::left << std::setw(40) << name << std::right << std::setw(10) << std::fixed << std::setprecision(2) << 1e3 / nanoseconds << " M samples/s" << std::endl;
+}
+
+int main()
+{
+    constexpr std::size_t N = 1 << 12;
+    constexpr std::size_t ITERATIONS = 1 << 22;
+    constexpr int OCTAVES = 4;
+
+#ifdef RAYTRACER_SIMD
+    std::cout << "SIMD kernels enabled" << std::endl;
+#else
+    std::cout << "Scalar kernels" << std::endl;
+#endif
+
+    // Points of a floor seen at a grazing angle, in structure-of-arrays form
+    // for the 4-wide calls.
+    std::vector<double> xs(N), ys(N), zs(N);
+    std::vector<Point> points;
+    for (std::size_t i = 0; i < N; ++i) {
+        xs[i] = 0.0137 * i - 20;
+        ys[i] = 0.25 * std::sin(0.01 * i);
+        zs[i] = 0.0071 * i + 3;
+        points.push_back(Point(xs[i], ys[i], zs[i]));
+    }
+    auto at = [&](std::size_t i) -> const Point & { return points[i & (N - 1)]; };
+
+    LegacyPerlinPattern legacy(Color::Green(), Color::Blue());
+    PerlinPattern pattern(Color::Green(), Color::Blue());
+    PerlinPattern fractal(Color::Green(), Color::Blue(), OCTAVES);
+
+    double before = benchmark::measure("legacy PerlinPattern::patternAt", ITERATIONS / 16, [&](std::size_t i) {
+        benchmark::doNotOptimize(legacy.patternAt(at(i)));
+    });
+    double after = benchmark::measure("PerlinPattern::patternAt", ITERATIONS, [&](std::size_t i) {
+        benchmark::doNotOptimize(pattern.patternAt(at(i)));
+    });
+    double noise = benchmark::measure("PerlinNoise::Noise", ITERATIONS, [&](std::size_t i) {
+        benchmark::doNotOptimize(PerlinNoise::Noise(at(i)));
+    });
+    double noise4 = benchmark::measure("PerlinNoise::Noise4, 4 points", ITERATIONS / 4, [&](std::size_t i) {
+        double out[4];
+        std::size_t j = (4 * i) & (N - 1);
+        PerlinNoise::Noise4(&xs[j], &ys[j], &zs[j], out);
+        benchmark::doNotOptimize(out);
+    }) / 4;
+    double fbm = benchmark::measure("PerlinPattern::patternAt, 4 octaves", ITERATIONS / OCTAVES, [&](std::size_t i) {
+        benchmark::doNotOptimize(fractal.patternAt(at(i)));
+    });
+    double fbm4 = benchmark::measure("PerlinNoise::Fbm4, 4 octaves, 4 points", ITERATIONS / OCTAVES / 4, [&](std::size_t i) {
+        double out[4];
+        std::size_t j = (4 * i) & (N - 1);
+        PerlinNoise::Fbm4(&xs[j], &ys[j], &zs[j], out, OCTAVES);
+        benchmark::doNotOptimize(out);
+    }) / 4;
+
+    std::cout << std::endl;
+    rate("legacy PerlinPattern", before);
+    rate("PerlinPattern", after);
+    rate("PerlinNoise::Noise", noise);
+    rate("PerlinNoise::Noise4", noise4);
+    rate("PerlinPattern, 4 octaves", fbm);
+    rate("PerlinNoise::Fbm4, 4 octaves", fbm4);
+    std::cout << "speedup: pattern " << std::setprecision(1) << before / after << "x, 4-wide noise " << noise / noise4 << "x, 4-wide fBm " << fbm / fbm4 << "x" << std::endl;
+    return 0;
+}
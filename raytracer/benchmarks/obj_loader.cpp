@@ -0,0 +1,95 @@
+#include "raytracer.hpp"
+
+#include "benchmark.hpp"
+
+// Load time of an OBJ file with the previous stringstream parser against
+// OBJLoader, serial and chunked, then of a ready-to-render TriangleMesh
+// built from the text against one mapped back from its MeshCache. Pass the
+// file to load; big assets show the difference best.
+
+using namespace raytracer;
+
+// The previous OBJFileParser::ParseString, kept here as the baseline.
+static std::size_t legacyParse(const std::string &filePath)
+{
+    std::ifstream objFileStream(filePath);
+    std::stringstream objFileContent;
+    objFileContent << objFileStream.rdbuf();
+
+    std::vector<Point> vertices;
+    std::vector<Vector> normals;
+    std::vector<Triangle> faces;
+
+    std::stringstream stream(objFileContent.str());
+    std::string line;
+    while (std::getline(stream, line)) {
+        std::stringstream lineStream(line);
+        std::string lineType;
+        lineStream >> lineType;
+
+        if (lineType == "v") {
+            double x, y, z;
+            lineStream >> x >> y >> z;
+            vertices.push_back(Point(x, y, z));
+        } else if (lineType == "vn") {
+            double x, y, z;
+            lineStream >> x >> y >> z;
+            normals.push_back(Vector(x, y, z));
+        } else if (lineType == "f") {
+            std::vector<int> face;
+            std::string faceVertex;
+            while (lineStream >> faceVertex) {
+                std::stringstream faceVertexStream(faceVertex);
+                std::string faceVertexIndex;
+                std::getline(faceVertexStream, faceVertexIndex, '/');
+                face.push_back(std::stoi(faceVertexIndex));
+            }
+            for (std::size_t i = 2; i < face.size(); i++)
+                faces.push_back(Triangle(vertices[face[0] - 1], vertices[face[i - 1] - 1], vertices[face[i] - 1]));
+        }
+    }
+    return faces.size();
+}
+
+template <typename F>
+static double seconds(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    std::string path = argc > 1 ? argv[1] : "teapot.obj";
+
+    std::size_t triangles = 0;
+    double legacy = seconds([&] { triangles = legacyParse(path); });
+    std::cout << std::left << std::setw(24) << "stringstream parser" << std::right << std::fixed << std::setprecision(3) << legacy << " s, "
+              << triangles << " triangles" << std::endl;
+
+    MeshData mesh;
+    double serial = seconds([&] { mesh = OBJLoader::LoadFile(path, 1); });
+    std::cout << std::left << std::setw(24) << "OBJLoader, serial" << std::right << std::fixed << std::setprecision(3) << serial << " s, "
+              << mesh.triangleCount() << " triangles" << std::endl;
+
+    double chunked = seconds([&] { mesh = OBJLoader::LoadFile(path); });
+    std::cout << std::left << std::setw(24) << "OBJLoader, chunked" << std::right << std::fixed << std::setprecision(3) << chunked << " s, "
+              << mesh.triangleCount() << " triangles" << std::endl;
+
+    std::cout << "speedup: serial " << std::setprecision(1) << legacy / serial << "x, chunked " << legacy / chunked << "x" << std::endl;
+
+    std::string cachePath = path + MeshCache::Extension;
+    std::remove(cachePath.c_str());
+    std::size_t size = 0;
+    double cold = seconds([&] { size = MeshCache::LoadFile(path).size(); });
+    std::cout << std::left << std::setw(24) << "MeshCache, cold" << std::right << std::fixed << std::setprecision(3) << cold << " s, "
+              << size << " triangles (parse, build, save)" << std::endl;
+
+    double warm = seconds([&] { size = MeshCache::LoadFile(path).size(); });
+    std::cout << std::left << std::setw(24) << "MeshCache, warm" << std::right << std::fixed << std::setprecision(3) << warm << " s, "
+              << size << " triangles" << std::endl;
+
+    std::cout << "speedup: cache " << std::setprecision(1) << cold / warm << "x" << std::endl;
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "raytracer.hpp"
+
+#include "benchmark.hpp"
+
+// Times the tuple, matrix and color operations that dominate
+// Computations and Material::lighting. Build once with RAYTRACER_SIMD=OFF
+// and once with SSE or AVX2 to compare the scalar and SIMD kernels.
+
+using namespace raytracer;
+
+int main()
+{
+    constexpr std::size_t N = 1 << 16;
+    constexpr std::size_t ITERATIONS = 20000000;
+
+#ifdef RAYTRACER_SIMD
+    std::cout << "SIMD kernels enabled" << std::endl;
+#else
+    std::cout << "Scalar kernels" << std::endl;
+#endif
+
+    std::vector<Tuple> points;
+    std::vector<Tuple> vectors;
+    std::vector<Color> colors;
+    for (std::size_t i = 0; i < N; ++i) {
+        double f = static_cast<double>(i) / N;
+        points.push_back(Point(f, 1 - f, 0.5 + f));
+        vectors.push_back(Vector(1 - f, f, 0.25 + f).normalize());
+        colors.push_back(Color(f, 0.5, 1 - f));
+    }
+
+    Matrix4 m = Matrix4::translation(1, 2, 3) * Matrix4::rotationY(M_PI / 5) * Matrix4::scaling(1, 0.5, 2);
+    Matrix4 n = m.inverse().transpose();
+    auto at = [&](auto &v, std::size_t i) -> auto & { return v[i & (N - 1)]; };
+
+    benchmark::measure("Tuple + Tuple", ITERATIONS, [&](std::size_t i) {
+        benchmark::doNotOptimize(at(points, i) + at(vectors, i));
+    });
+    benchmark::measure("Tuple * double", ITERATIONS, [&](std::size_t i) {
+        benchmark::doNotOptimize(at(vectors, i) * 1.5);
+    });
+    benchmark::measure("Tuple::dot", ITERATIONS, [&](std::size_t i) {
+        benchmark::doNotOptimize(at(vectors, i).dot(at(vectors, i + 1)));
+    });
+    benchmark::measure("Tuple::cross", ITERATIONS, [&](std::size_t i) {
+        benchmark::doNotOptimize(at(vectors, i).cross(at(vectors, i + 1)));
+    });
+    benchmark::measure("Tuple::normalize", ITERATIONS, [&](std::size_t i) {
+        benchmark::doNotOptimize(at(points, i).normalize());
+    });
+    benchmark::measure("Tuple::reflect", ITERATIONS, [&](std::size_t i) {
+        benchmark::doNotOptimize(at(vectors, i).reflect(at(vectors, i + 1)));
+    });
+    benchmark::measure("Matrix4 * Tuple", ITERATIONS, [&](std::size_t i) {
+        benchmark::doNotOptimize(m * at(points, i));
+    });
+
+    // The body of Computations: position, normal to world space, over point.
+    benchmark::measure("Computations kernel", ITERATIONS / 4, [&](std::size_t i) {
+        Tuple point = at(points, i) + at(vectors, i) * 2.5;
+        Tuple normal = n * (m * point);
+        normal.w = 0;
+        normal = normal.normalize();
+        Tuple eye = -at(vectors, i);
+        Tuple over = point + normal * EPSILON;
+        Tuple reflect = at(vectors, i).reflect(normal);
+        benchmark::doNotOptimize(normal.dot(eye));
+        benchmark::doNotOptimize(over);
+        benchmark::doNotOptimize(reflect);
+    });
+
+    benchmark::measure("Color * Color", ITERATIONS, [&](std::size_t i) {
+        benchmark::doNotOptimize(at(colors, i) * at(colors, i + 1));
+    });
+    benchmark::measure("Color + Color", ITERATIONS, [&](std::size_t i) {
+        benchmark::doNotOptimize(at(colors, i) + at(colors, i + 1));
+    });
+
+    // The body of Material::lighting without the pattern lookup.
+    benchmark::measure("Material::lighting kernel", ITERATIONS / 4, [&](std::size_t i) {
+        Color effective = at(colors, i) * Color(1, 1, 1);
+        Tuple lightv = (Point(-10, 10, -10) - at(points, i)).normalize();
+        double ldn = lightv.dot(at(vectors, i));
+        Tuple reflectv = (-lightv).reflect(at(vectors, i));
+        double rde = reflectv.dot(at(vectors, i + 1));
+        benchmark::doNotOptimize(effective * 0.1 + effective * 0.9 * ldn + Color(1, 1, 1) * 0.9 * rde);
+    });
+
+    return 0;
+}
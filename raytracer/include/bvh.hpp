@@ -0,0 +1,209 @@
+#ifndef __BVH_HPP__
+#define __BVH_HPP__
+
+#include "intersections.hpp"
+#include "shape.hpp"
+
+#include <cstdint>
+
+namespace raytracer {
+
+    // Flattened bounding volume hierarchy over an indexed set of primitives.
+    //
+    // Nodes are stored depth first in one array: the left child of a node is
+    // the next node, the right child is found through an index, and leaves
+    // point at a run of the contiguous primitive index array. Traversal walks
+    // the array with a fixed-size stack instead of recursing.
+    class LinearBVH {
+    public:
+        static constexpr int BinCount = 12;
+        static constexpr int MaxDepth = 64;
+
+        struct Node {
+            float min[3];
+            float max[3];
+            std::uint32_t offset; // leaf: first entry in indices(), interior: right child
+            std::uint32_t count;  // primitives in a leaf, 0 for an interior node
+        };
+
+    public:
+        LinearBVH() = default;
+
+        // Builds the hierarchy over primitives 0..bounds.size()-1 using the
+        // binned surface area heuristic. Leaves hold at most maxLeafSize
+        // primitives unless their centroids cannot be separated.
+        void build(const std::vector<Bounds> &bounds, int maxLeafSize);
+
+        // Takes over nodes and indices laid out as build() leaves them, for
+        // a hierarchy built earlier and stored, as MeshCache does.
+        void assign(std::vector<Node> nodes, std::vector<std::uint32_t> indices);
+
+    public:
+        bool empty() const { return m_nodes.empty(); }
+        Bounds bounds() const;
+        const std::vector<Node> &nodes() const { return m_nodes; }
+        const std::vector<std::uint32_t> &indices() const { return m_indices; }
+
+        // Calls visit(primitive, closest) for the primitives of every leaf the
+        // ray reaches, nearest node first. Nodes whose entry distance is beyond
+        // `closest` are skipped; visit may lower `closest` as hits are found.
+        template <typename Visit>
+        void traverse(const Ray &ray, double &closest, Visit &&visit) const;
+
+        // Same walk restricted to nodes overlapping [tmin, closest].
+        template <typename Visit>
+        void traverse(const Ray &ray, double tmin, double &closest, Visit &&visit) const;
+
+        // Calls test(primitive) for the primitives of the leaves the ray
+        // reaches in [0, tmax] and stops at the first one that returns true.
+        template <typename Test>
+        bool any(const Ray &ray, double tmax, Test &&test) const;
+
+    private:
+        // Shared traversal loop over the nodes overlapping [tmin, closest]:
+        // visit(primitive, closest) returns true to stop the walk, in which
+        // case walk() returns true as well.
+        template <typename Visit>
+        bool walk(const Ray &ray, double tmin, double &closest, Visit &&visit) const;
+
+        struct Primitive {
+            Bounds bounds;
+            Point centroid;
+            std::uint32_t index;
+        };
+
+        std::uint32_t buildNode(std::vector<Primitive> &primitives, std::size_t begin, std::size_t end, int depth);
+
+        static bool intersectNode(const Node &node, const double origin[3], const double invDirection[3], double &entry, double &exit);
+
+        int m_maxLeafSize = 4;
+        std::vector<Node> m_nodes;
+        std::vector<std::uint32_t> m_indices;
+    };
+
+    static_assert(sizeof(LinearBVH::Node) == 32, "BVH nodes must stay half a cache line");
+
+    template <typename Visit>
+    void LinearBVH::traverse(const Ray &ray, double &closest, Visit &&visit) const
+    {
+        traverse(ray, -std::numeric_limits<double>::infinity(), closest, std::forward<Visit>(visit));
+    }
+
+    template <typename Visit>
+    void LinearBVH::traverse(const Ray &ray, double tmin, double &closest, Visit &&visit) const
+    {
+        walk(ray, tmin, closest, [&](std::uint32_t primitive, double &nearest) {
+            visit(primitive, nearest);
+            return false;
+        });
+    }
+
+    template <typename Test>
+    bool LinearBVH::any(const Ray &ray, double tmax, Test &&test) const
+    {
+        return walk(ray, 0, tmax, [&](std::uint32_t primitive, double &) {
+            return test(primitive);
+        });
+    }
+
+    template <typename Visit>
+    bool LinearBVH::walk(const Ray &ray, double tmin, double &closest, Visit &&visit) const
+    {
+        if (m_nodes.empty())
+            return false;
+
+        Tuple o = ray.origin();
+        Tuple d = ray.direction();
+        const double origin[3] = {o.x, o.y, o.z};
+        const double invDirection[3] = {1 / d.x, 1 / d.y, 1 / d.z};
+
+        struct Entry {
+            std::uint32_t node;
+            double tmin;
+        };
+        Entry stack[MaxDepth + 1];
+        int top = 0;
+
+        double entry, exit;
+        if (!intersectNode(m_nodes[0], origin, invDirection, entry, exit) || exit < tmin)
+            return false;
+        stack[top++] = {0, entry};
+
+        while (top > 0) {
+            Entry entry = stack[--top];
+            if (entry.tmin > closest)
+                continue;
+
+            const Node &node = m_nodes[entry.node];
+            if (node.count > 0) {
+                for (std::uint32_t i = node.offset; i < node.offset + node.count; ++i)
+                    if (visit(m_indices[i], closest))
+                        return true;
+                continue;
+            }
+
+            // Push the farther child first so the nearer one is popped next.
+            std::uint32_t left = entry.node + 1;
+            std::uint32_t right = node.offset;
+            double tleft, tright;
+            bool hitLeft = intersectNode(m_nodes[left], origin, invDirection, tleft, exit) && exit >= tmin;
+            bool hitRight = intersectNode(m_nodes[right], origin, invDirection, tright, exit) && exit >= tmin;
+
+            if (hitLeft && hitRight) {
+                if (tleft <= tright) {
+                    stack[top++] = {right, tright};
+                    stack[top++] = {left, tleft};
+                } else {
+                    stack[top++] = {left, tleft};
+                    stack[top++] = {right, tright};
+                }
+            } else if (hitLeft) {
+                stack[top++] = {left, tleft};
+            } else if (hitRight) {
+                stack[top++] = {right, tright};
+            }
+        }
+        return false;
+    }
+
+    // Shape wrapper around a LinearBVH.
+    //
+    // Takes ownership of the shapes, like KDTree, and answers intersect(),
+    // occluded() and closestHit() front to back, skipping any node that
+    // starts beyond the closest hit found so far. The shapes become its
+    // children, as with Group::add, so their normals and patterns see the
+    // BVH's transform and every one above it.
+    class BVH : public AShape {
+    public:
+        BVH(std::vector<Shape *> shapes, int maxLeafSize = 4);
+        ~BVH();
+
+        BVH(const BVH &) = delete;
+        BVH &operator=(const BVH &) = delete;
+
+    public:
+        Intersections localIntersect(const Ray &) const override;
+        bool localOccluded(const Ray &, double tmax) const override;
+        std::optional<Intersection> localClosestHit(const Ray &, double tmin, double tmax) const override;
+        Vector localNormalAt(const Point &) const override;
+        Bounds bounds() const override;
+        void commit(const Matrix4 &parentInverse) override;
+
+    public:
+        std::size_t size() const;
+        const LinearBVH &tree() const;
+
+    private:
+        // The ray in the space the tree was built in. Once committed, the
+        // BVH passes world rays on to its children like a Group and only
+        // the traversal needs them in its own space.
+        Ray treeRay(const Ray &) const;
+
+    private:
+        std::vector<Shape *> m_shapes;
+        LinearBVH m_tree;
+    };
+
+} // namespace raytracer
+
+#endif // __BVH_HPP__
@@ -1,19 +1,19 @@
 #ifndef __CAMERA_HPP__
 #define __CAMERA_HPP__
 
-#include "matrix.hpp"
+#include "matrix4.hpp"
+#include "point.hpp"
+#include "progress.hpp"
+#include "tile_scheduler.hpp"
 #include "utils.hpp"
 
+#include <span>
+
 namespace raytracer {
     class Ray;
     class Canvas;
     class World;
 
-    class ProgressBar {
-    public:
-        virtual void tick() = 0;
-    };
-
     class Camera {
     public:
         // Constructor for the Camera class
@@ -22,8 +22,19 @@ namespace raytracer {
         // Method for computing the ray for a pixel
         Ray rayForPixel(int px, int py) const;
 
+        // Fills the directions of the primary rays of a tile in structure of
+        // arrays form, row by row within the tile. Every span needs room for
+        // tile.pixels() values; all the rays start at origin().
+        void generateRays(const Tile &tile, std::span<double> dx, std::span<double> dy, std::span<double> dz) const;
+
         // Method for rendering the scene
-        Canvas render(const World &world, ProgressBar *pb = nullptr) const;
+        Canvas render(const World &world, ProgressReporter *progress = nullptr) const;
+
+        // Renders the scene tile by tile: options.threads threads claim tiles
+        // of options.tileSize pixels, rounded up to the canvas tile
+        // alignment, in options.order until none are left.
+        // Progress, if given, is reported once per finished tile.
+        Canvas render(const World &world, const RenderOptions &options, ProgressReporter *progress = nullptr) const;
 
     public:
         const int hsize;          // The horizontal size of the image
@@ -40,7 +51,18 @@ namespace raytracer {
         const double pixelSize; // The size of each pixel in world units
 
     public:
-        Matrix transform; // The transformation matrix of the camera
+        const Matrix4 &transform() const { return m_transform; }
+        const Matrix4 &inverseTransform() const { return m_inverse; }
+        const Point &origin() const { return m_origin; }
+
+        // Sets the view transform and caches its inverse and the eye position.
+        // The transform must be invertible.
+        void setTransform(const Matrix4 &transform);
+
+    private:
+        Matrix4 m_transform; // The transformation matrix of the camera
+        Matrix4 m_inverse;   // m_transform.inverse(), kept in sync by setTransform
+        Point m_origin;      // The eye position in world space
     };
 
 } // namespace raytracer
@@ -4,36 +4,104 @@
 #include "color.hpp"
 #include "utils.hpp"
 
+#include <cstdint>
+
 namespace raytracer {
+    struct Tile;
+
+    // Storage of one pixel in a canvas.
+    enum class PixelFormat {
+        RGB32F,  // three floats
+        RGBA32F, // four floats, alpha set to 1 by writePixel
+        RGB64F,  // three doubles
+    };
+
+    // Size in bytes of one pixel of the given format.
+    std::size_t bytesPerPixel(PixelFormat format);
+
+    // Rectangle of a canvas, addressed in its own coordinates. A view does
+    // not own its pixels and must not outlive the canvas it came from.
+    class CanvasView {
+    public:
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+        PixelFormat format() const { return m_format; }
 
+        Color pixelAt(int x, int y) const;
+        void writePixel(int x, int y, const Color &color);
+
+        // Raw bytes of row y of the view, width() pixels in format().
+        std::byte *data(int y) const { return m_origin + y * m_stride; }
+
+    private:
+        friend class Canvas;
+        CanvasView(std::byte *origin, std::size_t stride, PixelFormat format, int width, int height);
+
+        std::byte *m_origin;
+        std::size_t m_stride;
+        PixelFormat m_format;
+        int m_width;
+        int m_height;
+    };
+
+    // Image held in a single cache-line aligned buffer, row after row. Each
+    // row is padded to a whole number of cache lines so that threads writing
+    // tiles whose left edge and width are multiples of tileAlignment() never
+    // touch the same line.
     class Canvas {
     public:
-        Canvas(int width, int height);
-        virtual ~Canvas() = default;
+        static constexpr std::size_t CacheLine = 64;
+
+    public:
+        Canvas(int width, int height, PixelFormat format = PixelFormat::RGB32F);
+        ~Canvas() = default;
 
         Canvas(const Canvas &);
         Canvas &operator=(const Canvas &);
 
-        Canvas(Canvas &&);
-        Canvas &operator=(Canvas &&);
+        Canvas(Canvas &&) = default;
+        Canvas &operator=(Canvas &&) = default;
 
     public:
         int width() const;
         int height() const;
+        PixelFormat format() const;
         Color pixelAt(int, int) const;
         void writePixel(int, int, const Color &);
         void drawCircle(int, int, int, const Color &);
 
     public:
+        // Bytes from the start of one row to the next.
+        std::size_t stride() const { return m_stride; }
+
+        // Smallest tile width, in pixels, that spans whole cache lines.
+        int tileAlignment() const;
+
+        // Raw bytes of row y, width() pixels in format().
+        const std::byte *data(int y) const { return m_pixels.get() + y * m_stride; }
+
+        CanvasView row(int y);
+        CanvasView tile(const Tile &tile);
+
+    public:
+        // Plain-text P3 image, for tests and small canvases.
         std::string toPPM() const;
+
+        // Streams a binary P6 image to filePath; see ImageWriter.
         void savePPM(const std::string &filePath) const;
 
     private:
+        struct Free {
+            void operator()(std::byte *p) const { ::operator delete[](p, std::align_val_t(CacheLine)); }
+        };
+
         int m_width;
         int m_height;
-        std::vector<std::vector<Color>> m_pixels;
+        PixelFormat m_format;
+        std::size_t m_stride;
+        std::unique_ptr<std::byte[], Free> m_pixels;
     };
 
 } // namespace raytracer
 
-#endif // __CANVAS_HPP__
\ No newline at end of file
+#endif // __CANVAS_HPP__
@@ -1,10 +1,11 @@
 #ifndef __COLOR_HPP__
 #define __COLOR_HPP__
 
+#include "simd.hpp"
 #include "utils.hpp"
 
 namespace raytracer {
-    class Color {
+    class RAYTRACER_SIMD_ALIGN Color {
     public:
         static Color Black() { return Color(0, 0, 0); }
         static Color White() { return Color(1, 1, 1); }
@@ -14,7 +15,7 @@ namespace raytracer {
 
     public:
         Color(double red, double green, double blue);
-        virtual ~Color() = default;
+        ~Color() = default;
 
         Color(const Color &) = default;
         Color &operator=(const Color &) = default;
@@ -38,8 +39,67 @@ namespace raytracer {
         double m_red;
         double m_green;
         double m_blue;
+#ifdef RAYTRACER_SIMD
+        double m_padding = 0; // keeps the channels loadable as one 4-wide vector
+#endif
     };
 
+#ifdef RAYTRACER_SIMD
+    static_assert(sizeof(Color) == 4 * sizeof(double), "Color must stay three channels and one padding lane");
+#else
+    static_assert(sizeof(Color) == 3 * sizeof(double), "Color must stay three packed doubles");
+#endif
+    static_assert(std::is_trivially_copyable_v<Color>);
+
+    inline Color::Color(double red, double green, double blue)
+        : m_red(red), m_green(green), m_blue(blue)
+    {
+    }
+
+    inline Color Color::operator+(const Color &other) const
+    {
+#ifdef RAYTRACER_SIMD
+        Color result(0, 0, 0);
+        simd::store(&result.m_red, simd::load(&m_red) + simd::load(&other.m_red));
+        return result;
+#else
+        return Color(m_red + other.m_red, m_green + other.m_green, m_blue + other.m_blue);
+#endif
+    }
+
+    inline Color Color::operator-(const Color &other) const
+    {
+#ifdef RAYTRACER_SIMD
+        Color result(0, 0, 0);
+        simd::store(&result.m_red, simd::load(&m_red) - simd::load(&other.m_red));
+        return result;
+#else
+        return Color(m_red - other.m_red, m_green - other.m_green, m_blue - other.m_blue);
+#endif
+    }
+
+    inline Color Color::operator*(const Color &other) const
+    {
+#ifdef RAYTRACER_SIMD
+        Color result(0, 0, 0);
+        simd::store(&result.m_red, simd::load(&m_red) * simd::load(&other.m_red));
+        return result;
+#else
+        return Color(m_red * other.m_red, m_green * other.m_green, m_blue * other.m_blue);
+#endif
+    }
+
+    inline Color Color::operator*(double scalar) const
+    {
+#ifdef RAYTRACER_SIMD
+        Color result(0, 0, 0);
+        simd::store(&result.m_red, simd::load(&m_red) * simd::broadcast(scalar));
+        return result;
+#else
+        return Color(m_red * scalar, m_green * scalar, m_blue * scalar);
+#endif
+    }
+
 } // namespace raytracer
 
 std::ostream &operator<<(std::ostream &, const raytracer::Color &);
@@ -21,7 +21,7 @@ namespace raytracer {
 
     private:
         static bool checkCaps(const Ray &r, double t);
-        void intersectCaps(const Ray &r, std::vector<Intersection> &xs) const;
+        void intersectCaps(const Ray &r, Intersections &xs) const;
     };
 
 } // namespace raytracer
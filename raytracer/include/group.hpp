@@ -4,6 +4,10 @@
 #include "intersections.hpp"
 #include "shape.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
 namespace raytracer {
 
     class Group : public AShape {
@@ -16,8 +20,16 @@ namespace raytracer {
 
     public:
         Intersections localIntersect(const Ray &) const override;
+        bool localOccluded(const Ray &, double tmax) const override;
+        std::optional<Intersection> localClosestHit(const Ray &, double tmin, double tmax) const override;
         Vector localNormalAt(const Point &) const override;
+        // Union of the children's parent-space bounds, empty for an empty
+        // group. Recomputed the first time it is needed in each transform
+        // epoch, so any setTransform or add below refreshes it; shapes
+        // whose own extent changes after that must call
+        // AShape::invalidateTransforms() themselves.
         Bounds bounds() const override;
+        void commit(const Matrix4 &parentInverse) override;
 
     public:
         void add(Shape *);
@@ -26,8 +38,23 @@ namespace raytracer {
         std::size_t size() const;
         Shape &operator[](std::size_t) const;
 
+    private:
+        // True when the ray cannot meet a child between tmin and tmax, the
+        // ray missing the group's box: bounds() for a ray in the group's
+        // space, the world bounds for the rays a committed group passes on.
+        bool misses(const Ray &, double tmin, double tmax) const;
+
     private:
         std::vector<Shape *> m_shapes;
+
+        // Cache behind bounds(), filled under the mutex once per epoch and
+        // read without locking while the epoch lasts.
+        mutable std::atomic<std::uint64_t> m_boundsEpoch;
+        mutable std::mutex m_boundsMutex;
+        mutable Bounds m_bounds;
+
+        // bounds() in world space, taken by commit().
+        Bounds m_worldBounds;
     };
 
 #include <algorithm>
@@ -55,6 +82,19 @@ namespace raytracer {
             return result;
         }
 
+        bool localOccluded(const Ray &ray, double tmax) const override
+        {
+            return m_root && occludedNode(ray, m_root, tmax);
+        }
+
+        std::optional<Intersection> localClosestHit(const Ray &ray, double tmin, double tmax) const override
+        {
+            std::optional<Intersection> hit;
+            if (m_root)
+                closestHitNode(ray, m_root, tmin, tmax, hit);
+            return hit;
+        }
+
         Vector localNormalAt(const Point &point) const override
         {
             throw std::runtime_error("KDTree::localNormalAt should never be called.");
@@ -92,14 +132,14 @@ namespace raytracer {
                 node->left = node->right = nullptr;
                 node->shapes.assign(begin, end);
                 for (auto shape : node->shapes) {
-                    node->bounds += shape->bounds();
+                    node->bounds += shape->parentSpaceBounds();
                 }
                 return node;
             }
 
             auto middle = begin + (end - begin) / 2;
             std::nth_element(begin, middle, end, [axis](const Shape *a, const Shape *b) {
-                return a->bounds().center()[axis] < b->bounds().center()[axis];
+                return a->parentSpaceBounds().center()[axis] < b->parentSpaceBounds().center()[axis];
             });
 
             Node *node = new Node();
@@ -130,6 +170,38 @@ namespace raytracer {
                 intersectNode(ray, node->right, result);
         }
 
+        bool occludedNode(const Ray &ray, const Node *node, double tmax) const
+        {
+            if (!node->bounds.intersect(ray))
+                return false;
+
+            for (const auto &shape : node->shapes)
+                if (shape->occluded(ray, tmax))
+                    return true;
+
+            return (node->left && occludedNode(ray, node->left, tmax)) || (node->right && occludedNode(ray, node->right, tmax));
+        }
+
+        void closestHitNode(const Ray &ray, const Node *node, double tmin, double &tmax, std::optional<Intersection> &hit) const
+        {
+            double t0, t1;
+            if (!node->bounds.intersect(ray, t0, t1) || t0 >= tmax || t1 < tmin)
+                return;
+
+            for (const auto &shape : node->shapes) {
+                if (auto h = shape->closestHit(ray, tmin, tmax)) {
+                    hit = h;
+                    tmax = h->t();
+                }
+            }
+
+            if (node->left)
+                closestHitNode(ray, node->left, tmin, tmax, hit);
+
+            if (node->right)
+                closestHitNode(ray, node->right, tmin, tmax, hit);
+        }
+
         int m_maxDepth;
         Node *m_root;
     };
@@ -0,0 +1,48 @@
+#ifndef __IMAGE_WRITER_HPP__
+#define __IMAGE_WRITER_HPP__
+
+#include "utils.hpp"
+
+#include <cstdint>
+
+namespace raytracer {
+    class Canvas;
+
+    enum class ImageFormat {
+        PPM, // binary P6, 8 bits per channel
+        PFM, // Portable Float Map, 32-bit float RGB
+        PNG, // 8-bit RGB in stored (uncompressed) deflate blocks
+    };
+
+    // Binary image encoders that stream a canvas to a file descriptor a
+    // few rows at a time through a fixed-size buffer, so writing a frame
+    // never holds more than that buffer on top of the canvas itself.
+    //
+    // 8-bit formats quantize like Canvas::toPPM: floor(c * 256) clamped to
+    // [0, 255]. Every writer returns the number of bytes written and throws
+    // std::runtime_error when the descriptor refuses them.
+    class ImageWriter {
+    public:
+        static std::size_t WritePPM(const Canvas &canvas, int fd);
+        static std::size_t WritePFM(const Canvas &canvas, int fd);
+        static std::size_t WritePNG(const Canvas &canvas, int fd);
+        static std::size_t Write(const Canvas &canvas, int fd, ImageFormat format);
+
+        // Writes to filePath in the format given by its extension (.ppm,
+        // .pfm or .png), replacing any existing file.
+        static std::size_t Save(const Canvas &canvas, const std::string &filePath);
+        static std::size_t Save(const Canvas &canvas, const std::string &filePath, ImageFormat format);
+
+        // ImageFormat for the extension of filePath; throws
+        // std::invalid_argument for anything else.
+        static ImageFormat FormatForPath(const std::string &filePath);
+
+    public:
+        // Checksums used by PNG, updated incrementally from `value`.
+        static std::uint32_t Crc32(const void *data, std::size_t size, std::uint32_t value = 0);
+        static std::uint32_t Adler32(const void *data, std::size_t size, std::uint32_t value = 1);
+    };
+
+} // namespace raytracer
+
+#endif // __IMAGE_WRITER_HPP__
@@ -2,9 +2,12 @@
 #define __INTERSECTIONS_HPP__
 
 #include "point.hpp"
+#include "small_vector.hpp"
 #include "utils.hpp"
 #include "vector.hpp"
 
+#include <cstdint>
+
 namespace raytracer {
     class Shape;
     class Ray;
@@ -31,13 +34,38 @@ namespace raytracer {
         Point underPoint;
     };
 
+    // Stack of the shapes a ray is inside at some point along it, innermost
+    // last. Walking a sorted intersection list and toggling each shape gives
+    // the refractive indices on both sides of every hit.
+    class ContainerTracker {
+    public:
+        static constexpr std::size_t InlineCapacity = 8;
+
+    public:
+        // Leaves the shape if the ray is inside it, enters it otherwise.
+        void toggle(const Shape &);
+
+        // Index of the innermost container, 1.0 (vacuum) when there is none.
+        double refractiveIndex() const;
+
+        std::size_t depth() const { return m_stack.size(); }
+
+    private:
+        SmallVector<const Shape *, InlineCapacity> m_stack;
+    };
+
     class Intersections;
 
     class Intersection {
 
     public:
-        Intersection(double, const Shape &);
-        virtual ~Intersection() = default;
+        // `primitive` tells shapes made of many primitives, like
+        // TriangleMesh, which one was hit.
+        Intersection(double, const Shape &, std::uint32_t primitive = 0);
+        // Triangle hit with its barycentric coordinates: the hit point is
+        // p1 + u * (p2 - p1) + v * (p3 - p1).
+        Intersection(double, const Shape &, double u, double v, std::uint32_t primitive = 0);
+        ~Intersection() = default;
 
         Intersection(const Intersection &) = default;
         Intersection &operator=(const Intersection &) = default;
@@ -48,22 +76,36 @@ namespace raytracer {
     public:
         bool operator==(const Intersection &) const;
         Computations prepareComputations(const Ray &, const Intersections &) const;
+        // For opaque hits, whose refraction indices are never read: skips
+        // the container walk and reports vacuum on both sides.
+        Computations prepareComputations(const Ray &) const;
 
     public:
         double t() const;
         const Shape &shape() const;
+        std::uint32_t primitive() const { return m_primitive; }
+        double u() const { return m_u; }
+        double v() const { return m_v; }
 
     private:
         double m_t;
         const Shape *m_shape;
+        std::uint32_t m_primitive;
+        double m_u;
+        double m_v;
     };
 
+    static_assert(std::is_trivially_copyable_v<Intersection>, "Intersection is stored in SmallVector");
+
     class Intersections {
+    public:
+        static constexpr std::size_t InlineCapacity = 8;
+
     public:
         Intersections();
         Intersections(std::initializer_list<Intersection>);
         Intersections(std::vector<Intersection>);
-        virtual ~Intersections() = default;
+        ~Intersections() = default;
 
         Intersections(const Intersections &) = default;
         Intersections &operator=(const Intersections &) = default;
@@ -78,13 +120,28 @@ namespace raytracer {
 
     public:
         const Intersection *hit() const;
+        Intersections &add(const Intersection &);
         Intersections &add(const Intersections &);
         Intersections &sort();
 
-        void forEachIntersection(std::function<void(const Intersection &)>) const;
+        // Sorted counterparts of add(): the list must already be sorted by t
+        // and stays sorted. Each hit slides back from the end into place,
+        // which is cheaper than append-then-sort for the short lists rays
+        // produce.
+        Intersections &insert(const Intersection &);
+        Intersections &merge(const Intersections &);
+
+        template <typename Visit>
+        void forEachIntersection(Visit &&visit) const
+        {
+            for (const auto &i : m_intersections)
+                visit(i);
+        }
 
     private:
-        std::vector<Intersection> m_intersections;
+        // Sized for a couple of two-hit primitives; larger lists spill to
+        // the heap.
+        SmallVector<Intersection, InlineCapacity> m_intersections;
     };
 
 } // namespace raytracer
@@ -0,0 +1,32 @@
+#ifndef __MAPPED_FILE_HPP__
+#define __MAPPED_FILE_HPP__
+
+#include "utils.hpp"
+
+#include <string_view>
+
+namespace raytracer {
+
+    // Read-only mapping of a whole file, unmapped on destruction. Throws
+    // std::runtime_error naming the file when it cannot be opened or mapped.
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string &filePath);
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+    public:
+        const char *data() const { return m_data; }
+        std::size_t size() const { return m_size; }
+        std::string_view view() const { return std::string_view(m_data, m_size); }
+
+    private:
+        const char *m_data;
+        std::size_t m_size;
+    };
+
+} // namespace raytracer
+
+#endif // __MAPPED_FILE_HPP__
@@ -3,6 +3,7 @@
 
 #include <array>
 #include <cstddef>
+#include <type_traits>
 
 #define MAX_MATRIX_SIZE 4
 
@@ -23,7 +24,7 @@ namespace raytracer {
     public:
         Matrix(std::size_t rows, std::size_t cols);
         Matrix(std::size_t rows, std::size_t cols, double *values);
-        virtual ~Matrix() = default;
+        ~Matrix() = default;
 
         Matrix(const Matrix &) = default;
         Matrix &operator=(const Matrix &) = default;
@@ -35,6 +36,7 @@ namespace raytracer {
         std::size_t rows() const;
         std::size_t cols() const;
         double *operator[](std::size_t);
+        const double *operator[](std::size_t) const;
         bool operator==(const Matrix &) const;
         Matrix operator*(const Matrix &) const;
         Tuple operator*(const Tuple &) const;
@@ -54,6 +56,9 @@ namespace raytracer {
         double m_matrix[MAX_MATRIX_SIZE][MAX_MATRIX_SIZE];
     };
 
+    static_assert(sizeof(Matrix) == 2 * sizeof(std::size_t) + MAX_MATRIX_SIZE * MAX_MATRIX_SIZE * sizeof(double), "Matrix must not carry a vtable");
+    static_assert(std::is_trivially_copyable_v<Matrix>);
+
 } // namespace raytracer
 
 #endif // __MATRIX_HPP__
@@ -0,0 +1,233 @@
+#ifndef __MATRIX4_HPP__
+#define __MATRIX4_HPP__
+
+#include "matrix.hpp"
+#include "simd.hpp"
+#include "tuple.hpp"
+
+#include <cstddef>
+
+namespace raytracer {
+    // Fixed-size 4x4 matrix used for every transform on the hot path.
+    //
+    // Unlike Matrix it carries no runtime dimensions and computes its
+    // determinant and inverse in closed form, so it can be copied, multiplied
+    // and inverted without going through submatrix/cofactor recursion.
+    // The transform factories mirror Matrix::translation() & co; a 4x4 Matrix
+    // converts with an explicit Matrix4(matrix).
+    // Under RAYTRACER_SIMD, rows are 32-byte aligned so the SIMD kernels can
+    // load them directly.
+    class RAYTRACER_SIMD_ALIGN Matrix4 {
+    public:
+        static constexpr Matrix4 identity()
+        {
+            Matrix4 result;
+            for (std::size_t i = 0; i < 4; ++i)
+                result.m_matrix[i][i] = 1;
+            return result;
+        }
+
+        static Matrix4 translation(double x, double y, double z);
+        static Matrix4 scaling(double x, double y, double z);
+        static Matrix4 rotationX(double radians);
+        static Matrix4 rotationY(double radians);
+        static Matrix4 rotationZ(double radians);
+        static Matrix4 shearing(double xy, double xz, double yx, double yz, double zx, double zy);
+        static Matrix4 viewTransform(const Tuple &from, const Tuple &to, const Tuple &up);
+
+    public:
+        constexpr Matrix4()
+            : m_matrix{}
+        {
+        }
+
+        constexpr Matrix4(const double (&values)[16])
+            : m_matrix{}
+        {
+            for (std::size_t i = 0; i < 4; ++i)
+                for (std::size_t j = 0; j < 4; ++j)
+                    m_matrix[i][j] = values[i * 4 + j];
+        }
+
+        // Copies a 4x4 matrix; any other size is a programming error.
+        explicit Matrix4(const Matrix &);
+
+        explicit operator Matrix() const;
+
+    public:
+        constexpr std::size_t rows() const { return 4; }
+        constexpr std::size_t cols() const { return 4; }
+        constexpr double *operator[](std::size_t row) { return m_matrix[row]; }
+        constexpr const double *operator[](std::size_t row) const { return m_matrix[row]; }
+
+        bool operator==(const Matrix4 &) const;
+        Tuple operator*(const Tuple &) const;
+
+        constexpr Matrix4 operator*(const Matrix4 &other) const
+        {
+            Matrix4 result;
+            for (std::size_t i = 0; i < 4; ++i)
+                for (std::size_t j = 0; j < 4; ++j)
+                    result.m_matrix[i][j] = m_matrix[i][0] * other.m_matrix[0][j] + m_matrix[i][1] * other.m_matrix[1][j] + m_matrix[i][2] * other.m_matrix[2][j] + m_matrix[i][3] * other.m_matrix[3][j];
+            return result;
+        }
+
+    public:
+        constexpr Matrix4 transpose() const
+        {
+            Matrix4 result;
+            for (std::size_t i = 0; i < 4; ++i)
+                for (std::size_t j = 0; j < 4; ++j)
+                    result.m_matrix[j][i] = m_matrix[i][j];
+            return result;
+        }
+
+        constexpr double determinant() const
+        {
+            const auto &m = m_matrix;
+
+            // 2x2 determinants of the two upper rows and of the two lower rows.
+            double s0 = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+            double s1 = m[0][0] * m[1][2] - m[1][0] * m[0][2];
+            double s2 = m[0][0] * m[1][3] - m[1][0] * m[0][3];
+            double s3 = m[0][1] * m[1][2] - m[1][1] * m[0][2];
+            double s4 = m[0][1] * m[1][3] - m[1][1] * m[0][3];
+            double s5 = m[0][2] * m[1][3] - m[1][2] * m[0][3];
+
+            double c5 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
+            double c4 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
+            double c3 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
+            double c2 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
+            double c1 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
+            double c0 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
+
+            return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        }
+
+        constexpr bool isInvertible() const
+        {
+            return determinant() != 0;
+        }
+
+        // True when the bottom row is 0 0 0 1, i.e. the matrix is a linear map
+        // followed by a translation. Every transform built from translation,
+        // scaling, rotation, shearing and viewTransform is affine.
+        constexpr bool isAffine() const
+        {
+            return m_matrix[3][0] == 0 && m_matrix[3][1] == 0 && m_matrix[3][2] == 0 && m_matrix[3][3] == 1;
+        }
+
+        // Closed-form inverse through the Laplace expansion of the 2x2 minors.
+        // The result is undefined (inf or NaN) when the matrix is not
+        // invertible.
+        constexpr Matrix4 generalInverse() const
+        {
+            const auto &m = m_matrix;
+
+            double s0 = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+            double s1 = m[0][0] * m[1][2] - m[1][0] * m[0][2];
+            double s2 = m[0][0] * m[1][3] - m[1][0] * m[0][3];
+            double s3 = m[0][1] * m[1][2] - m[1][1] * m[0][2];
+            double s4 = m[0][1] * m[1][3] - m[1][1] * m[0][3];
+            double s5 = m[0][2] * m[1][3] - m[1][2] * m[0][3];
+
+            double c5 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
+            double c4 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
+            double c3 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
+            double c2 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
+            double c1 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
+            double c0 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
+
+            double invdet = 1.0 / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+
+            Matrix4 r;
+            r.m_matrix[0][0] = (m[1][1] * c5 - m[1][2] * c4 + m[1][3] * c3) * invdet;
+            r.m_matrix[0][1] = (-m[0][1] * c5 + m[0][2] * c4 - m[0][3] * c3) * invdet;
+            r.m_matrix[0][2] = (m[3][1] * s5 - m[3][2] * s4 + m[3][3] * s3) * invdet;
+            r.m_matrix[0][3] = (-m[2][1] * s5 + m[2][2] * s4 - m[2][3] * s3) * invdet;
+
+            r.m_matrix[1][0] = (-m[1][0] * c5 + m[1][2] * c2 - m[1][3] * c1) * invdet;
+            r.m_matrix[1][1] = (m[0][0] * c5 - m[0][2] * c2 + m[0][3] * c1) * invdet;
+            r.m_matrix[1][2] = (-m[3][0] * s5 + m[3][2] * s2 - m[3][3] * s1) * invdet;
+            r.m_matrix[1][3] = (m[2][0] * s5 - m[2][2] * s2 + m[2][3] * s1) * invdet;
+
+            r.m_matrix[2][0] = (m[1][0] * c4 - m[1][1] * c2 + m[1][3] * c0) * invdet;
+            r.m_matrix[2][1] = (-m[0][0] * c4 + m[0][1] * c2 - m[0][3] * c0) * invdet;
+            r.m_matrix[2][2] = (m[3][0] * s4 - m[3][1] * s2 + m[3][3] * s0) * invdet;
+            r.m_matrix[2][3] = (-m[2][0] * s4 + m[2][1] * s2 - m[2][3] * s0) * invdet;
+
+            r.m_matrix[3][0] = (-m[1][0] * c3 + m[1][1] * c1 - m[1][2] * c0) * invdet;
+            r.m_matrix[3][1] = (m[0][0] * c3 - m[0][1] * c1 + m[0][2] * c0) * invdet;
+            r.m_matrix[3][2] = (-m[3][0] * s3 + m[3][1] * s1 - m[3][2] * s0) * invdet;
+            r.m_matrix[3][3] = (m[2][0] * s3 - m[2][1] * s1 + m[2][2] * s0) * invdet;
+            return r;
+        }
+
+        // Inverse of an affine matrix: invert the upper 3x3 block through its
+        // adjugate and send the translation through it. Only valid when
+        // isAffine() holds.
+        constexpr Matrix4 affineInverse() const
+        {
+            const auto &m = m_matrix;
+
+            double a00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+            double a01 = m[0][2] * m[2][1] - m[0][1] * m[2][2];
+            double a02 = m[0][1] * m[1][2] - m[0][2] * m[1][1];
+            double a10 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+            double a11 = m[0][0] * m[2][2] - m[0][2] * m[2][0];
+            double a12 = m[0][2] * m[1][0] - m[0][0] * m[1][2];
+            double a20 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+            double a21 = m[0][1] * m[2][0] - m[0][0] * m[2][1];
+            double a22 = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+
+            double invdet = 1.0 / (m[0][0] * a00 + m[0][1] * a10 + m[0][2] * a20);
+
+            Matrix4 r;
+            r.m_matrix[0][0] = a00 * invdet;
+            r.m_matrix[0][1] = a01 * invdet;
+            r.m_matrix[0][2] = a02 * invdet;
+            r.m_matrix[1][0] = a10 * invdet;
+            r.m_matrix[1][1] = a11 * invdet;
+            r.m_matrix[1][2] = a12 * invdet;
+            r.m_matrix[2][0] = a20 * invdet;
+            r.m_matrix[2][1] = a21 * invdet;
+            r.m_matrix[2][2] = a22 * invdet;
+
+            for (std::size_t i = 0; i < 3; ++i)
+                r.m_matrix[i][3] = -(r.m_matrix[i][0] * m[0][3] + r.m_matrix[i][1] * m[1][3] + r.m_matrix[i][2] * m[2][3]);
+
+            r.m_matrix[3][3] = 1;
+            return r;
+        }
+
+        // Undefined, like generalInverse(), unless isInvertible().
+        constexpr Matrix4 inverse() const
+        {
+            return isAffine() ? affineInverse() : generalInverse();
+        }
+
+    private:
+        double m_matrix[4][4];
+    };
+
+    static_assert(sizeof(Matrix4) == 16 * sizeof(double), "Matrix4 must stay a bare 4x4 array");
+    static_assert(std::is_trivially_copyable_v<Matrix4>);
+
+    inline Tuple Matrix4::operator*(const Tuple &t) const
+    {
+#ifdef RAYTRACER_SIMD
+        simd::double4 v = simd::load(&t.x);
+        Tuple result(0, 0, 0, 0);
+        simd::store(&result.x, simd::sum4(simd::load(m_matrix[0]) * v, simd::load(m_matrix[1]) * v, simd::load(m_matrix[2]) * v, simd::load(m_matrix[3]) * v));
+        return result;
+#else
+        return Tuple(m_matrix[0][0] * t.x + m_matrix[0][1] * t.y + m_matrix[0][2] * t.z + m_matrix[0][3] * t.w,
+                     m_matrix[1][0] * t.x + m_matrix[1][1] * t.y + m_matrix[1][2] * t.z + m_matrix[1][3] * t.w,
+                     m_matrix[2][0] * t.x + m_matrix[2][1] * t.y + m_matrix[2][2] * t.z + m_matrix[2][3] * t.w,
+                     m_matrix[3][0] * t.x + m_matrix[3][1] * t.y + m_matrix[3][2] * t.z + m_matrix[3][3] * t.w);
+#endif
+    }
+
+} // namespace raytracer
+
+#endif // __MATRIX4_HPP__
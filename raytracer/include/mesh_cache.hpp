@@ -0,0 +1,60 @@
+#ifndef __MESH_CACHE_HPP__
+#define __MESH_CACHE_HPP__
+
+#include "triangle_mesh.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+namespace raytracer {
+
+    // Binary image of a TriangleMesh, its vertex and index arrays together
+    // with the LinearBVH built over them, so that an OBJ file is parsed and
+    // its hierarchy built once and every later run maps the result back in.
+    //
+    // A cache file is a fixed header followed by one section per array.
+    // Sections start on 64-byte boundaries and are located by offsets from
+    // the start of the file, never by pointers, so the file can be mapped at
+    // any address and each array read straight from the mapping. The header
+    // records a format version, the byte order and the key of the source and
+    // build parameters; a file whose header does not match is ignored and
+    // rebuilt, never patched up.
+    class MeshCache {
+    public:
+        static constexpr std::uint32_t Version = 1;
+        static constexpr const char *Extension = ".rtmesh";
+
+    public:
+        // Mesh of the OBJ file at objFilePath. Read from cachePath (by
+        // default objFilePath + Extension) when that file was built from the
+        // same bytes with the same maxLeafSize; parsed, built and saved
+        // there otherwise. A cache that cannot be written only costs the
+        // next call another parse.
+        static TriangleMesh LoadFile(const std::string &objFilePath, int maxLeafSize = 4);
+        static TriangleMesh LoadFile(const std::string &objFilePath, const std::string &cachePath, int maxLeafSize = 4);
+
+        // Mesh stored at cachePath under key, or nothing when the file is
+        // missing, truncated, from another format version or byte order, or
+        // stored under another key.
+        static std::optional<TriangleMesh> Load(const std::string &cachePath, std::uint64_t key);
+
+        // Writes mesh to cachePath under key. The file is written next to
+        // its destination and renamed into place, so readers never see half
+        // a cache. Throws std::runtime_error when it cannot be written.
+        static void Save(const TriangleMesh &mesh, const std::string &cachePath, std::uint64_t key);
+
+        // Cache key of a mesh built from the OBJ text `source` with
+        // maxLeafSize: a hash of the bytes, the build parameters and the
+        // layout of the stored arrays.
+        static std::uint64_t Key(std::string_view source, int maxLeafSize);
+
+        // 64-bit FNV-1a taken over 8-byte little-endian words, folding the
+        // high half back down after each one so that every input bit reaches
+        // the low bits, then over the remaining bytes. Updated incrementally
+        // from `value`.
+        static std::uint64_t Hash(const void *data, std::size_t size, std::uint64_t value = 0xcbf29ce484222325ull);
+    };
+
+} // namespace raytracer
+
+#endif // __MESH_CACHE_HPP__
@@ -0,0 +1,38 @@
+#ifndef __NOISE_HPP__
+#define __NOISE_HPP__
+
+#include "tuple.hpp"
+
+namespace raytracer {
+
+    // Ken Perlin's improved noise over a fixed permutation table, and the
+    // fractal sums of octaves built on it. The table is a compile-time
+    // constant, so evaluating noise allocates nothing and needs no set-up.
+    //
+    // The *4 functions evaluate four points given as separate x, y and z
+    // arrays; out[i] is what the scalar function returns for point i. The
+    // lattice lookups run lane by lane, the gradients and blends on all four
+    // lanes at once, with the SIMD kernels under RAYTRACER_SIMD.
+    class PerlinNoise {
+    public:
+        // Noise at a point, in [-1, 1] and 0 on every lattice point.
+        static double Noise(double x, double y, double z);
+        static double Noise(const Tuple &point);
+
+        // Fractional Brownian motion: `octaves` layers of noise, each at
+        // lacunarity times the frequency and gain times the amplitude of the
+        // one before. A single octave is Noise itself.
+        static double Fbm(const Tuple &point, int octaves, double lacunarity = 2, double gain = 0.5);
+
+        // The same sum over the absolute value of each layer.
+        static double Turbulence(const Tuple &point, int octaves, double lacunarity = 2, double gain = 0.5);
+
+    public:
+        static void Noise4(const double x[4], const double y[4], const double z[4], double out[4]);
+        static void Fbm4(const double x[4], const double y[4], const double z[4], double out[4], int octaves, double lacunarity = 2, double gain = 0.5);
+        static void Turbulence4(const double x[4], const double y[4], const double z[4], double out[4], int octaves, double lacunarity = 2, double gain = 0.5);
+    };
+
+} // namespace raytracer
+
+#endif // __NOISE_HPP__
@@ -3,17 +3,31 @@
 
 #include "utils.hpp"
 
+#include <cstdint>
+
 namespace raytracer {
     class Triangle;
-
+    class SmoothTriangle;
+    struct MeshData;
+
+    // Triangles of an OBJ file as shapes. faces holds every triangle, flat.
+    // The ones with a normal on every corner are also in smoothFaces, and
+    // smoothIndices links the two: to shade smoothly where the file allows
+    // and flat elsewhere, take smoothFaces[smoothIndices[i]] for face i
+    // unless that index is Flat, and faces[i] otherwise.
     class OBJFileParser {
+    public:
+        static constexpr std::size_t Flat = SIZE_MAX; // smoothIndices entry of a face without a smooth version
+
     private:
-        OBJFileParser(const std::vector<Point> &vertices, const std::vector<Vector> &normals, const std::vector<Triangle> &faces)
-            : vertices(vertices), normals(normals), faces(faces) {}
+        OBJFileParser(const std::vector<Point> &vertices, const std::vector<Vector> &normals, const std::vector<Triangle> &faces, const std::vector<SmoothTriangle> &smoothFaces,
+                      const std::vector<std::size_t> &smoothIndices)
+            : vertices(vertices), normals(normals), faces(faces), smoothFaces(smoothFaces), smoothIndices(smoothIndices) {}
 
     public:
         static OBJFileParser ParseFile(const std::string &filePath);
         static OBJFileParser ParseString(const std::string &fileContent);
+        static OBJFileParser FromMesh(const MeshData &mesh);
 
         ~OBJFileParser() = default;
 
@@ -22,7 +36,9 @@ namespace raytracer {
 
         std::vector<Point> vertices;
         std::vector<Vector> normals;
-        std::vector<Triangle> faces;
+        std::vector<Triangle> faces;             // every triangle, flat
+        std::vector<SmoothTriangle> smoothFaces; // the triangles whose vertices all have a normal, in file order
+        std::vector<std::size_t> smoothIndices;  // per face, its entry in smoothFaces or Flat
     };
 
 } // namespace raytracer
@@ -0,0 +1,62 @@
+#ifndef __OBJ_LOADER_HPP__
+#define __OBJ_LOADER_HPP__
+
+#include "utils.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace raytracer {
+
+    // Triangle mesh in flat arrays, as read from an OBJ file. Polygons are
+    // fanned into triangles around their first vertex; triangle i uses the
+    // entries 3i, 3i + 1 and 3i + 2 of every index array.
+    struct MeshData {
+        static constexpr std::uint32_t None = UINT32_MAX; // corner without a texcoord or normal
+
+        std::vector<double> positions; // x y z per vertex
+        std::vector<double> texcoords; // u v per texture coordinate
+        std::vector<double> normals;   // x y z per normal
+
+        std::vector<std::uint32_t> positionIndices;
+        std::vector<std::uint32_t> texcoordIndices; // empty if no face has vt, else one per corner
+        std::vector<std::uint32_t> normalIndices;   // empty if no face has vn, else one per corner
+
+        std::size_t vertexCount() const { return positions.size() / 3; }
+        std::size_t texcoordCount() const { return texcoords.size() / 2; }
+        std::size_t normalCount() const { return normals.size() / 3; }
+        std::size_t triangleCount() const { return positionIndices.size() / 3; }
+    };
+
+    // OBJ reader that parses the file in place from a read-only mapping with
+    // std::from_chars, touching the allocator only to grow the output
+    // arrays. Reads v, vt, vn and f records (v, v/vt, v//vn and v/vt/vn
+    // corners, negative indices counting back from the last record) and
+    // skips every other line.
+    //
+    // Large inputs are cut into newline-aligned chunks parsed in parallel
+    // and stitched back together, giving the same mesh as a serial parse.
+    // Malformed numbers and out of range indices throw std::runtime_error
+    // naming the line.
+    class OBJLoader {
+    public:
+        static constexpr std::size_t ChunkSize = 1 << 20; // bytes per chunk when picked automatically
+
+    public:
+        // `chunks` is the number of pieces to parse in parallel: 1 parses
+        // serially, 0 picks one per ChunkSize bytes, up to four per
+        // hardware thread, and stays serial on a single hardware thread.
+        static MeshData LoadFile(const std::string &filePath, int chunks = 0);
+        static MeshData Parse(std::string_view content, int chunks = 0);
+
+        // The parallel half of Parse: content cut into `chunks` pieces and
+        // stitched back together, or nothing when a piece fails to parse or
+        // an index leaves the file, which Parse then reports through a
+        // serial parse.
+        static std::optional<MeshData> ParseChunks(std::string_view content, int chunks);
+    };
+
+} // namespace raytracer
+
+#endif // __OBJ_LOADER_HPP__
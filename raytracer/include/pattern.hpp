@@ -2,9 +2,12 @@
 #define __PATTERN_HPP__
 
 #include "color.hpp"
-#include "matrix.hpp"
+#include "matrix4.hpp"
 #include "utils.hpp"
 
+#include <atomic>
+#include <cstdint>
+
 namespace raytracer {
     class Point;
     class Shape;
@@ -16,13 +19,30 @@ namespace raytracer {
         APattern(const Color &a, const Color &b);
         Color patternAtShape(const Shape &, const Point &point) const;
 
+    public:
+        const Matrix4 &transform() const;
+        const Matrix4 &inverseTransform() const;
+        // The transform must be invertible.
+        void setTransform(const Matrix4 &);
+
+        // Stamp of the transform, never 0: a fresh value for every pattern
+        // built and every setTransform, copied along with the transform.
+        // Equal generations mean equal transforms.
+        std::uint64_t generation() const;
+
     protected:
         virtual Color patternAt(const Point &point) const = 0;
 
     public:
         Color a;
         Color b;
-        Matrix transform;
+
+    private:
+        Matrix4 m_transform;
+        Matrix4 m_inverse; // cached m_transform.inverse(), kept in sync by setTransform
+        std::uint64_t m_generation;
+
+        static std::atomic<std::uint64_t> s_generation;
     };
 
     class StripePattern : public APattern {
@@ -53,14 +73,19 @@ namespace raytracer {
         Color patternAt(const Point &point) const override;
     };
 
+    // Blends a and b by PerlinNoise: plain noise with the defaults, a
+    // fractal sum of octaves otherwise.
     class PerlinPattern : public APattern {
     public:
-        PerlinPattern(const Color &a, const Color &b);
+        PerlinPattern(const Color &a, const Color &b, int octaves = 1);
 
         Color patternAt(const Point &point) const override;
 
-    private:
-        double noise(const Point &point) const;
+    public:
+        int octaves;
+        double lacunarity;
+        double gain;
+        bool turbulence; // sum the absolute value of each octave
     };
 
 } // namespace raytracer
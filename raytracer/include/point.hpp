@@ -7,7 +7,7 @@ namespace raytracer {
     class Point : public Tuple {
     public:
         Point(double x, double y, double z);
-        virtual ~Point() = default;
+        ~Point() = default;
 
         Point(const Point &) = default;
         Point &operator=(const Point &) = default;
@@ -15,6 +15,9 @@ namespace raytracer {
         Point(Point &&) = default;
         Point &operator=(Point &&) = default;
     };
+
+    static_assert(sizeof(Point) == sizeof(Tuple), "Point must not add state to Tuple");
+    static_assert(std::is_trivially_copyable_v<Point>);
 } // namespace raytracer
 
 #endif // __POINT_HPP__
@@ -0,0 +1,73 @@
+#ifndef __PROGRESS_HPP__
+#define __PROGRESS_HPP__
+
+#include "utils.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+namespace raytracer {
+
+    // Snapshot of a render handed to progress callbacks.
+    struct ProgressEvent {
+        std::size_t done;  // pixels finished so far
+        std::size_t total; // pixels in the frame
+        double elapsed;    // seconds since the render started
+        double remaining;  // estimated seconds left, 0 until the first pixel is done
+        bool finished;     // set on the single final event
+
+        double fraction() const { return total == 0 ? 1.0 : static_cast<double>(done) / total; }
+    };
+
+    // Collects render progress from any number of threads and forwards it
+    // to a callback at most once per interval, plus one final event.
+    //
+    // Every thread adds to its own cache-line sized counter, so reporting a
+    // finished tile is a relaxed store and a clock read. Whichever thread
+    // notices the interval has passed sums the counters and runs the
+    // callback; the others carry on. No locks are taken.
+    class ProgressReporter {
+    public:
+        using Callback = std::function<void(const ProgressEvent &)>;
+
+    public:
+        ProgressReporter(Callback callback, std::chrono::milliseconds interval = std::chrono::milliseconds(100));
+
+        ProgressReporter(const ProgressReporter &) = delete;
+        ProgressReporter &operator=(const ProgressReporter &) = delete;
+
+    public:
+        // Resets the counters for a frame of `total` pixels rendered by at
+        // most `threads` threads.
+        void start(std::size_t total, int threads);
+
+        // Records `pixels` more pixels done by thread `thread` (0-based) and
+        // reports if the interval has elapsed.
+        void add(int thread, std::size_t pixels);
+
+        // Sends the final event. Call once all threads are done.
+        void finish();
+
+        // Current aggregate, callable from any thread.
+        ProgressEvent snapshot(bool finished = false) const;
+
+    private:
+        struct alignas(64) Counter {
+            std::atomic<std::size_t> value{0};
+        };
+
+        double elapsed() const;
+
+        Callback m_callback;
+        std::chrono::nanoseconds m_interval;
+        std::chrono::steady_clock::time_point m_start;
+        std::size_t m_total;
+        std::unique_ptr<Counter[]> m_counters;
+        int m_threads;
+        std::atomic<std::int64_t> m_nextReport; // nanoseconds after m_start
+        std::atomic<bool> m_reporting;
+    };
+
+} // namespace raytracer
+
+#endif // __PROGRESS_HPP__
@@ -4,12 +4,12 @@
 #include "tuple.hpp"
 
 namespace raytracer {
-    class Matrix;
+    class Matrix4;
 
     class Ray {
     public:
         Ray(const Tuple &, const Tuple &);
-        virtual ~Ray() = default;
+        ~Ray() = default;
 
         Ray(const Ray &) = default;
         Ray &operator=(const Ray &) = default;
@@ -21,13 +21,16 @@ namespace raytracer {
         Tuple origin() const;
         Tuple direction() const;
         Tuple position(double) const;
-        Ray transform(const Matrix &) const;
+        Ray transform(const Matrix4 &) const;
 
     private:
         Tuple m_origin;
         Tuple m_direction;
     };
 
+    static_assert(sizeof(Ray) == 2 * sizeof(Tuple), "Ray must stay two packed tuples");
+    static_assert(std::is_trivially_copyable_v<Ray>);
+
 } // namespace raytracer
 
 #endif // __RAY_HPP__
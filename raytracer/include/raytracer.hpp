@@ -1,6 +1,7 @@
 #ifndef __RAYTRACER_HPP__
 #define __RAYTRACER_HPP__
 
+#include "bvh.hpp"
 #include "camera.hpp"
 #include "canvas.hpp"
 #include "color.hpp"
@@ -8,18 +9,28 @@
 #include "cube.hpp"
 #include "cylinder.hpp"
 #include "group.hpp"
+#include "image_writer.hpp"
 #include "intersections.hpp"
 #include "lights.hpp"
+#include "mapped_file.hpp"
 #include "material.hpp"
 #include "matrix.hpp"
+#include "matrix4.hpp"
+#include "mesh_cache.hpp"
+#include "noise.hpp"
 #include "obj_file_parser.hpp"
+#include "obj_loader.hpp"
 #include "pattern.hpp"
 #include "plane.hpp"
 #include "point.hpp"
+#include "progress.hpp"
 #include "ray.hpp"
 #include "shape.hpp"
+#include "small_vector.hpp"
 #include "sphere.hpp"
+#include "tile_scheduler.hpp"
 #include "triangle.hpp"
+#include "triangle_mesh.hpp"
 #include "tuple.hpp"
 #include "vector.hpp"
 #include "world.hpp"
@@ -2,17 +2,31 @@
 #define __SHAPE_HPP__
 
 #include "material.hpp"
-#include "matrix.hpp"
+#include "matrix4.hpp"
 #include "point.hpp"
 #include "ray.hpp"
 #include "utils.hpp"
 #include "vector.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
 namespace raytracer {
+    class Intersection;
     class Intersections;
 
     class Bounds {
     public:
+        // The empty box: adding any point or box to it yields that point or box.
+        static Bounds Empty()
+        {
+            constexpr double inf = std::numeric_limits<double>::infinity();
+            Bounds b(Point(inf, inf, inf));
+            b.max = Point(-inf, -inf, -inf);
+            return b;
+        }
+
         Bounds(Point const &p)
             : min(p), max(p)
         {
@@ -44,16 +58,32 @@ namespace raytracer {
 
         Bounds &operator+=(Bounds const &b)
         {
-            return add(b.min).add(b.max);
+            min.x = std::min(min.x, b.min.x);
+            min.y = std::min(min.y, b.min.y);
+            min.z = std::min(min.z, b.min.z);
+
+            max.x = std::max(max.x, b.max.x);
+            max.y = std::max(max.y, b.max.y);
+            max.z = std::max(max.z, b.max.z);
+
+            return *this;
         }
 
         bool intersect(Ray const &r) const
+        {
+            double tmin, tmax;
+            return intersect(r, tmin, tmax);
+        }
+
+        // Same slab test, but also reports the parametric interval along the
+        // ray inside the box so callers can order and prune boxes.
+        bool intersect(Ray const &r, double &tmin, double &tmax) const
         {
             auto o = r.origin();
             auto d = r.direction();
 
-            double tmin = (min.x - o.x) / d.x;
-            double tmax = (max.x - o.x) / d.x;
+            tmin = (min.x - o.x) / d.x;
+            tmax = (max.x - o.x) / d.x;
 
             if (tmin > tmax)
                 std::swap(tmin, tmax);
@@ -91,6 +121,41 @@ namespace raytracer {
             return true;
         }
 
+        // True for the box nothing was added to.
+        bool empty() const
+        {
+            return min.x > max.x || min.y > max.y || min.z > max.z;
+        }
+
+        // Box around this one sent through the affine transform m, by Arvo's
+        // method: each extent of the result is the translation plus, for
+        // every axis, the smaller and the larger of the matrix entry times
+        // the box's extent on that axis. As tight as transforming the eight
+        // corners, for 18 products instead of 128. Zero entries are skipped,
+        // so an unbounded axis only spreads to the axes it actually reaches.
+        Bounds transform(const Matrix4 &m) const
+        {
+            if (empty())
+                return *this;
+
+            Bounds result = Empty();
+            for (int i = 0; i < 3; ++i) {
+                double lo = m[i][3], hi = m[i][3];
+                for (int j = 0; j < 3; ++j) {
+                    double a = m[i][j];
+                    if (a == 0)
+                        continue;
+                    double e = a * min[j];
+                    double f = a * max[j];
+                    lo += std::min(e, f);
+                    hi += std::max(e, f);
+                }
+                result.min[i] = lo;
+                result.max[i] = hi;
+            }
+            return result;
+        }
+
         Point center() const
         {
             return ((min + max) / 2).asPoint();
@@ -101,6 +166,12 @@ namespace raytracer {
             return (max - min).asVector();
         }
 
+        double surfaceArea() const
+        {
+            Tuple d = max - min;
+            return 2 * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+
         Point min, max;
     };
 
@@ -117,34 +188,79 @@ namespace raytracer {
 
     public:
         virtual Intersections intersect(const Ray &) const = 0;
+        // True as soon as the ray hits anything at 0 <= t < tmax. Cheaper
+        // than intersect() when only the existence of a blocker matters.
+        virtual bool occluded(const Ray &, double tmax) const = 0;
+        // Nearest intersection with tmin <= t < tmax, if any. Containers
+        // shrink tmax as they go, so anything farther than the best hit so
+        // far is skipped.
+        virtual std::optional<Intersection> closestHit(const Ray &, double tmin, double tmax) const = 0;
         virtual Tuple normalAt(const Tuple &) const = 0;
+        // Normal at a point of a known hit, for shapes whose normal depends
+        // on which of their primitives was hit.
+        virtual Tuple normalAt(const Tuple &, const Intersection &) const = 0;
         virtual Point worldToObject(const Point &) const = 0;
         virtual Vector normalToWorld(const Vector &) const = 0;
+        // Matrix of worldToObject(): the inverse transforms of this shape
+        // and of every group above it, combined.
+        virtual Matrix4 worldToObjectTransform() const = 0;
+        // World point in the space of a pattern applied to this shape.
+        virtual Point worldToPattern(const Point &, const APattern &) const = 0;
 
     public:
-        virtual const Matrix &transform() const = 0;
+        virtual const Matrix4 &transform() const = 0;
+        virtual const Matrix4 &inverseTransform() const = 0;
+        virtual const Matrix4 &transposedInverseTransform() const = 0;
         virtual const Material &material() const = 0;
 
-        virtual Matrix &transform() = 0;
+        // The transform must be invertible: its inverse is cached as is.
+        virtual void setTransform(const Matrix4 &) = 0;
         virtual Material &material() = 0;
 
         virtual Bounds bounds() const = 0;
+        // bounds() in the space of the group holding the shape, its own
+        // transform applied.
+        virtual Bounds parentSpaceBounds() const = 0;
+
+        // Folds parentInverse, the world-to-object matrix of the group
+        // holding the shape, into the shape's own; see World::commit.
+        virtual void commit(const Matrix4 &parentInverse) = 0;
     };
 
     class AShape : public Shape {
     public:
-        virtual const Matrix &transform() const;
+        virtual const Matrix4 &transform() const;
+        virtual const Matrix4 &inverseTransform() const;
+        virtual const Matrix4 &transposedInverseTransform() const;
         virtual const Material &material() const;
-        virtual Matrix &transform();
+        virtual void setTransform(const Matrix4 &);
         virtual Material &material();
+        Bounds parentSpaceBounds() const override;
+        void commit(const Matrix4 &parentInverse) override;
+
+        // True from commit() until the next transform or hierarchy change.
+        bool committed() const;
 
         Intersections intersect(const Ray &) const final;
+        bool occluded(const Ray &, double tmax) const final;
+        std::optional<Intersection> closestHit(const Ray &, double tmin, double tmax) const final;
         Tuple normalAt(const Tuple &) const final;
+        Tuple normalAt(const Tuple &, const Intersection &) const final;
         Point worldToObject(const Point &) const final;
         Vector normalToWorld(const Vector &) const final;
+        Matrix4 worldToObjectTransform() const final;
+        Point worldToPattern(const Point &, const APattern &) const final;
 
         Shape *parent = nullptr;
 
+    public:
+        // Scene-wide counter moved on by every setTransform of a shape or a
+        // pattern and every change of parent through Group, so that matrices
+        // derived from several transforms know when they are stale. Scenes
+        // must not change while they are being rendered.
+        static std::uint64_t transformEpoch();
+        static void invalidateTransforms();
+
     protected:
         AShape();
         virtual ~AShape();
@@ -157,10 +273,58 @@ namespace raytracer {
 
         virtual Intersections localIntersect(const Ray &) const = 0;
         virtual Vector localNormalAt(const Point &) const = 0;
+        // Defaults to localNormalAt(point).
+        virtual Vector localNormalAt(const Point &, const Intersection &) const;
+
+        // Both fall back on localIntersect(); containers override them to
+        // stop early or prune by distance.
+        virtual bool localOccluded(const Ray &, double tmax) const;
+        virtual std::optional<Intersection> localClosestHit(const Ray &, double tmin, double tmax) const;
+
+        // The ray in the space the local* functions work in.
+        Ray localRay(const Ray &) const;
 
     protected:
-        Matrix m_transform;
+        Matrix4 m_transform;
+        Matrix4 m_inverse;          // cached m_transform.inverse(), kept in sync by setTransform
+        Matrix4 m_inverseTranspose; // cached m_inverse.transpose(), used to bring normals to world space
         Material m_material;
+
+        // Baked by commit(): world space straight to object space, every
+        // group above the shape included, valid while the transform epoch
+        // stays at m_commitEpoch. A committed group passes rays on
+        // untouched, as its children carry its transform already.
+        Matrix4 m_worldInverse;
+        Matrix4 m_worldInverseTranspose;
+        std::uint64_t m_commitEpoch;
+        bool m_passThrough;
+
+    private:
+        // World-to-pattern matrix of the first pattern looked up on the
+        // shape in the current epoch, keyed on that pattern's generation()
+        // rather than its address, so neither an assignment nor a new
+        // pattern at the same address can pick up a stale matrix. It is
+        // filled once per epoch under the mutex and never rewritten while
+        // the epoch lasts, so render threads read it without locking.
+        // Copies start out empty.
+        struct PatternCache {
+            PatternCache() = default;
+            PatternCache(const PatternCache &) {}
+            PatternCache &operator=(const PatternCache &)
+            {
+                epoch.store(0, std::memory_order_relaxed);
+                return *this;
+            }
+
+            std::atomic<std::uint64_t> epoch = 0;
+            std::uint64_t generation = 0;
+            Matrix4 matrix;
+            std::mutex mutex;
+        };
+
+        mutable PatternCache m_patternCache;
+
+        static std::atomic<std::uint64_t> s_transformEpoch;
     };
 
 } // namespace raytracer
@@ -0,0 +1,110 @@
+#ifndef __SIMD_HPP__
+#define __SIMD_HPP__
+
+// Minimal 4-wide double vector used by the Tuple, Color and Matrix4 kernels
+// when the library is configured with RAYTRACER_SIMD. AVX2 builds map a
+// double4 onto one __m256d, anything else onto a pair of SSE2 __m128d.
+// All loads and stores expect 32-byte aligned storage.
+
+#ifdef RAYTRACER_SIMD
+#define RAYTRACER_SIMD_ALIGN alignas(32)
+#else
+#define RAYTRACER_SIMD_ALIGN
+#endif
+
+#ifdef RAYTRACER_SIMD
+
+#include <immintrin.h>
+
+namespace raytracer::simd {
+
+#if defined(__AVX2__)
+
+    struct double4 {
+        __m256d v;
+    };
+
+    inline double4 load(const double *p) { return {_mm256_load_pd(p)}; }
+    inline void store(double *p, double4 a) { _mm256_store_pd(p, a.v); }
+    inline double4 broadcast(double s) { return {_mm256_set1_pd(s)}; }
+
+    inline double4 operator+(double4 a, double4 b) { return {_mm256_add_pd(a.v, b.v)}; }
+    inline double4 operator-(double4 a, double4 b) { return {_mm256_sub_pd(a.v, b.v)}; }
+    inline double4 operator*(double4 a, double4 b) { return {_mm256_mul_pd(a.v, b.v)}; }
+    inline double4 operator/(double4 a, double4 b) { return {_mm256_div_pd(a.v, b.v)}; }
+
+    // (x, y, z, w) -> (y, z, x, w)
+    inline double4 yzxw(double4 a) { return {_mm256_permute4x64_pd(a.v, _MM_SHUFFLE(3, 0, 2, 1))}; }
+
+    // (x, y, z, w) -> (z, x, y, w)
+    inline double4 zxyw(double4 a) { return {_mm256_permute4x64_pd(a.v, _MM_SHUFFLE(3, 1, 0, 2))}; }
+
+    // (x, y, z, w) -> (x, y, z, 0)
+    inline double4 xyz0(double4 a) { return {_mm256_blend_pd(a.v, _mm256_setzero_pd(), 0b1000)}; }
+
+    inline double sum(double4 a)
+    {
+        __m128d s = _mm_add_pd(_mm256_castpd256_pd128(a.v), _mm256_extractf128_pd(a.v, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    }
+
+    // (sum(a), sum(b), sum(c), sum(d))
+    inline double4 sum4(double4 a, double4 b, double4 c, double4 d)
+    {
+        __m256d ab = _mm256_hadd_pd(a.v, b.v);
+        __m256d cd = _mm256_hadd_pd(c.v, d.v);
+        return {_mm256_add_pd(_mm256_permute2f128_pd(ab, cd, 0x20), _mm256_permute2f128_pd(ab, cd, 0x31))};
+    }
+
+#else
+
+    struct double4 {
+        __m128d lo, hi;
+    };
+
+    inline double4 load(const double *p) { return {_mm_load_pd(p), _mm_load_pd(p + 2)}; }
+    inline void store(double *p, double4 a)
+    {
+        _mm_store_pd(p, a.lo);
+        _mm_store_pd(p + 2, a.hi);
+    }
+    inline double4 broadcast(double s) { return {_mm_set1_pd(s), _mm_set1_pd(s)}; }
+
+    inline double4 operator+(double4 a, double4 b) { return {_mm_add_pd(a.lo, b.lo), _mm_add_pd(a.hi, b.hi)}; }
+    inline double4 operator-(double4 a, double4 b) { return {_mm_sub_pd(a.lo, b.lo), _mm_sub_pd(a.hi, b.hi)}; }
+    inline double4 operator*(double4 a, double4 b) { return {_mm_mul_pd(a.lo, b.lo), _mm_mul_pd(a.hi, b.hi)}; }
+    inline double4 operator/(double4 a, double4 b) { return {_mm_div_pd(a.lo, b.lo), _mm_div_pd(a.hi, b.hi)}; }
+
+    // (x, y, z, w) -> (y, z, x, w)
+    inline double4 yzxw(double4 a) { return {_mm_shuffle_pd(a.lo, a.hi, 0b01), _mm_shuffle_pd(a.lo, a.hi, 0b10)}; }
+
+    // (x, y, z, w) -> (z, x, y, w)
+    inline double4 zxyw(double4 a) { return {_mm_shuffle_pd(a.hi, a.lo, 0b00), _mm_shuffle_pd(a.lo, a.hi, 0b11)}; }
+
+    // (x, y, z, w) -> (x, y, z, 0)
+    inline double4 xyz0(double4 a) { return {a.lo, _mm_move_sd(_mm_setzero_pd(), a.hi)}; }
+
+    inline double sum(double4 a)
+    {
+        __m128d s = _mm_add_pd(a.lo, a.hi);
+        return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    }
+
+    // (sum(a), sum(b), sum(c), sum(d))
+    inline double4 sum4(double4 a, double4 b, double4 c, double4 d)
+    {
+        __m128d sa = _mm_add_pd(a.lo, a.hi);
+        __m128d sb = _mm_add_pd(b.lo, b.hi);
+        __m128d sc = _mm_add_pd(c.lo, c.hi);
+        __m128d sd = _mm_add_pd(d.lo, d.hi);
+        return {_mm_add_pd(_mm_unpacklo_pd(sa, sb), _mm_unpackhi_pd(sa, sb)),
+                _mm_add_pd(_mm_unpacklo_pd(sc, sd), _mm_unpackhi_pd(sc, sd))};
+    }
+
+#endif
+
+} // namespace raytracer::simd
+
+#endif // RAYTRACER_SIMD
+
+#endif // __SIMD_HPP__
@@ -0,0 +1,175 @@
+#ifndef __SMALL_VECTOR_HPP__
+#define __SMALL_VECTOR_HPP__
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace raytracer {
+
+    // Vector of trivially copyable values that keeps its first N elements
+    // inline and only moves to the heap when it grows past them.
+    //
+    // Used for the short per-ray lists (intersections, refraction
+    // containers) so that tracing a ray does not touch the allocator in the
+    // common case.
+    template <typename T, std::size_t N>
+    class SmallVector {
+        static_assert(std::is_trivially_copyable_v<T>, "SmallVector copies its elements with memcpy");
+        static_assert(N > 0, "SmallVector needs room for at least one inline element");
+
+    public:
+        static constexpr std::size_t InlineCapacity = N;
+
+    public:
+        SmallVector()
+            : m_data(inlineData()), m_size(0), m_capacity(N)
+        {
+        }
+
+        SmallVector(std::initializer_list<T> values)
+            : SmallVector()
+        {
+            reserve(values.size());
+            for (const auto &value : values)
+                m_data[m_size++] = value;
+        }
+
+        ~SmallVector()
+        {
+            release();
+        }
+
+        SmallVector(const SmallVector &other)
+            : SmallVector()
+        {
+            *this = other;
+        }
+
+        SmallVector &operator=(const SmallVector &other)
+        {
+            if (this != &other) {
+                m_size = 0;
+                reserve(other.m_size);
+                std::memcpy(static_cast<void *>(m_data), other.m_data, other.m_size * sizeof(T));
+                m_size = other.m_size;
+            }
+            return *this;
+        }
+
+        SmallVector(SmallVector &&other) noexcept
+            : SmallVector()
+        {
+            *this = std::move(other);
+        }
+
+        SmallVector &operator=(SmallVector &&other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            if (!other.isInline()) {
+                // Steal the heap buffer and leave other empty and inline.
+                release();
+                m_data = other.m_data;
+                m_size = other.m_size;
+                m_capacity = other.m_capacity;
+                other.m_data = other.inlineData();
+                other.m_capacity = N;
+            } else {
+                // Inline storage cannot be stolen; it fits in ours anyway.
+                std::memcpy(static_cast<void *>(m_data), other.m_data, other.m_size * sizeof(T));
+                m_size = other.m_size;
+            }
+            other.m_size = 0;
+            return *this;
+        }
+
+    public:
+        std::size_t size() const { return m_size; }
+        std::size_t capacity() const { return m_capacity; }
+        bool empty() const { return m_size == 0; }
+
+        // True while the elements still live in the inline buffer.
+        bool isInline() const { return m_data == inlineData(); }
+
+        T &operator[](std::size_t index) { return m_data[index]; }
+        const T &operator[](std::size_t index) const { return m_data[index]; }
+
+        T &back() { return m_data[m_size - 1]; }
+        const T &back() const { return m_data[m_size - 1]; }
+
+        T *begin() { return m_data; }
+        T *end() { return m_data + m_size; }
+        const T *begin() const { return m_data; }
+        const T *end() const { return m_data + m_size; }
+
+    public:
+        void push_back(const T &value)
+        {
+            if (m_size == m_capacity) {
+                // value may alias an element; keep a copy across the regrow.
+                T copy = value;
+                reserve(2 * m_capacity);
+                m_data[m_size++] = copy;
+                return;
+            }
+            m_data[m_size++] = value;
+        }
+
+        void pop_back() { --m_size; }
+        void clear() { m_size = 0; }
+
+        T *erase(T *position)
+        {
+            std::memmove(static_cast<void *>(position), position + 1, (end() - position - 1) * sizeof(T));
+            --m_size;
+            return position;
+        }
+
+        T *insert(T *position, const T &value)
+        {
+            std::size_t index = position - m_data;
+            T copy = value;
+            if (m_size == m_capacity)
+                reserve(2 * m_capacity);
+            std::memmove(static_cast<void *>(m_data + index + 1), m_data + index, (m_size - index) * sizeof(T));
+            m_data[index] = copy;
+            ++m_size;
+            return m_data + index;
+        }
+
+        void reserve(std::size_t capacity)
+        {
+            if (capacity <= m_capacity)
+                return;
+
+            T *data = static_cast<T *>(::operator new(capacity * sizeof(T)));
+            std::memcpy(static_cast<void *>(data), m_data, m_size * sizeof(T));
+            release();
+            m_data = data;
+            m_capacity = capacity;
+        }
+
+    private:
+        T *inlineData() { return reinterpret_cast<T *>(m_inline); }
+        const T *inlineData() const { return reinterpret_cast<const T *>(m_inline); }
+
+        void release()
+        {
+            if (!isInline())
+                ::operator delete(m_data);
+        }
+
+        T *m_data;
+        std::size_t m_size;
+        std::size_t m_capacity;
+        alignas(T) unsigned char m_inline[N * sizeof(T)];
+    };
+
+} // namespace raytracer
+
+#endif // __SMALL_VECTOR_HPP__
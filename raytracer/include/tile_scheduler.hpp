@@ -0,0 +1,65 @@
+#ifndef __TILE_SCHEDULER_HPP__
+#define __TILE_SCHEDULER_HPP__
+
+#include "canvas.hpp"
+#include "utils.hpp"
+
+#include <atomic>
+
+namespace raytracer {
+
+    // Order in which the tiles of an image are handed out.
+    enum class TileOrder {
+        Scanline, // row by row, left to right
+        Hilbert,  // along a Hilbert curve, so consecutive tiles touch
+        Spiral,   // outwards from the center of the image
+    };
+
+    struct RenderOptions {
+        // Edge of a square tile, in pixels. Camera::render rounds it up to a
+        // multiple of the canvas's tileAlignment(): 16 for RGB32F, 8 for
+        // RGB64F, 4 for RGBA32F.
+        int tileSize = 16;
+        TileOrder order = TileOrder::Hilbert;     // order tiles are claimed in
+        int threads = 0;                          // render threads, 0 for one per hardware thread
+        PixelFormat format = PixelFormat::RGB32F; // storage of the rendered canvas
+    };
+
+    // Pixel rectangle [x0, x1) x [y0, y1).
+    struct Tile {
+        int x0, y0, x1, y1;
+
+        int width() const { return x1 - x0; }
+        int height() const { return y1 - y0; }
+        int pixels() const { return width() * height(); }
+    };
+
+    // Cuts an image into tiles and hands them out one at a time to any
+    // number of threads through a single atomic counter.
+    class TileScheduler {
+    public:
+        TileScheduler(int width, int height, int tileSize = 16, TileOrder order = TileOrder::Hilbert);
+
+        TileScheduler(const TileScheduler &) = delete;
+        TileScheduler &operator=(const TileScheduler &) = delete;
+
+    public:
+        // Claims the next tile; false once every tile has been handed out.
+        // Safe to call concurrently.
+        bool next(Tile &tile);
+
+        // Makes every tile available again.
+        void reset();
+
+    public:
+        std::size_t count() const { return m_tiles.size(); }
+        const std::vector<Tile> &tiles() const { return m_tiles; }
+
+    private:
+        std::vector<Tile> m_tiles;
+        std::atomic<std::size_t> m_next;
+    };
+
+} // namespace raytracer
+
+#endif // __TILE_SCHEDULER_HPP__
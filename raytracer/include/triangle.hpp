@@ -13,6 +13,7 @@ namespace raytracer {
         virtual ~Triangle() = default;
 
         virtual Intersections localIntersect(const Ray &) const;
+        virtual std::optional<Intersection> localClosestHit(const Ray &, double tmin, double tmax) const;
         virtual Vector localNormalAt(const Point &) const;
         virtual Bounds bounds() const;
 
@@ -22,6 +23,26 @@ namespace raytracer {
         const Vector e1;
         const Vector e2;
         const Vector normal;
+
+    private:
+        // Moller-Trumbore test; sets t and the barycentric u and v, and
+        // returns true on a hit.
+        bool hitDistance(const Ray &, double &t, double &u, double &v) const;
+    };
+
+    // Triangle whose normal is interpolated from one normal per vertex,
+    // using the u and v its intersections carry.
+    class SmoothTriangle : public Triangle {
+    public:
+        SmoothTriangle(const Point &p1, const Point &p2, const Point &p3, const Vector &n1, const Vector &n2, const Vector &n3);
+        virtual ~SmoothTriangle() = default;
+
+        using Triangle::localNormalAt;
+        Vector localNormalAt(const Point &, const Intersection &) const override;
+
+        const Vector n1;
+        const Vector n2;
+        const Vector n3;
     };
 
 } // namespace raytracer
@@ -0,0 +1,61 @@
+#ifndef __TRIANGLE_MESH_HPP__
+#define __TRIANGLE_MESH_HPP__
+
+#include "bvh.hpp"
+#include "obj_loader.hpp"
+#include "shape.hpp"
+
+namespace raytracer {
+
+    // Many triangles behind a single shape: one transform and material, the
+    // vertices and indices of a MeshData, and a LinearBVH over triangle
+    // indices. Edges and normals are computed from the shared vertex buffer
+    // when a triangle is tested, so a triangle costs its three indices plus
+    // its share of the hierarchy instead of a whole Triangle object.
+    // Triangles with a vertex normal on each corner shade smooth, from the
+    // u and v their intersections carry.
+    //
+    // Copies share the geometry and hierarchy, so instancing a mesh under
+    // another transform or material is cheap. Hits match those of a
+    // Triangle built from the same three points.
+    class TriangleMesh : public AShape {
+    public:
+        TriangleMesh(MeshData mesh, int maxLeafSize = 4);
+        // Mesh whose hierarchy over its triangles was built beforehand.
+        TriangleMesh(MeshData mesh, LinearBVH tree);
+        virtual ~TriangleMesh() = default;
+
+        TriangleMesh(const TriangleMesh &) = default;
+        TriangleMesh &operator=(const TriangleMesh &) = default;
+
+    public:
+        Intersections localIntersect(const Ray &) const override;
+        bool localOccluded(const Ray &, double tmax) const override;
+        std::optional<Intersection> localClosestHit(const Ray &, double tmin, double tmax) const override;
+        Vector localNormalAt(const Point &) const override;
+        Vector localNormalAt(const Point &, const Intersection &) const override;
+        Bounds bounds() const override;
+
+    public:
+        std::size_t size() const;
+        const MeshData &mesh() const;
+        const LinearBVH &tree() const;
+
+        Point vertex(std::uint32_t triangle, int corner) const;
+        Vector faceNormal(std::uint32_t triangle) const;
+
+    private:
+        struct Geometry {
+            MeshData mesh;
+            LinearBVH tree;
+        };
+
+        // Moller-Trumbore test against triangle i; sets t, u and v on a hit.
+        bool hitDistance(const Ray &, std::uint32_t i, double &t, double &u, double &v) const;
+
+        std::shared_ptr<const Geometry> m_geometry;
+    };
+
+} // namespace raytracer
+
+#endif // __TRIANGLE_MESH_HPP__
@@ -1,20 +1,24 @@
 #ifndef __TUPLE_HPP__
 #define __TUPLE_HPP__
 
+#include "simd.hpp"
 #include "utils.hpp"
 
 namespace raytracer {
     class Point;
     class Vector;
 
-    class Tuple {
+    // Under RAYTRACER_SIMD, tuples are 32-byte aligned so that x, y, z and w
+    // can be moved in and out of SIMD registers with a single aligned load
+    // or store.
+    class RAYTRACER_SIMD_ALIGN Tuple {
     public:
         static Tuple point(double, double, double);
         static Tuple vector(double, double, double);
 
     public:
         Tuple(double x, double y, double z, double w);
-        virtual ~Tuple() = default;
+        ~Tuple() = default;
 
         Tuple(const Tuple &) = default;
         Tuple &operator=(const Tuple &) = default;
@@ -54,6 +58,116 @@ namespace raytracer {
             w;
     };
 
+    static_assert(sizeof(Tuple) == 4 * sizeof(double), "Tuple must stay four packed doubles");
+    static_assert(std::is_trivially_copyable_v<Tuple>);
+
+#ifdef RAYTRACER_SIMD
+    namespace simd {
+        inline double4 load(const Tuple &t)
+        {
+            return load(&t.x);
+        }
+
+        inline Tuple make(double4 v)
+        {
+            Tuple result(0, 0, 0, 0);
+            store(&result.x, v);
+            return result;
+        }
+    } // namespace simd
+#endif
+
+    inline Tuple::Tuple(double x, double y, double z, double w)
+        : x(x), y(y), z(z), w(w)
+    {
+    }
+
+    inline Tuple Tuple::operator+(const Tuple &other) const
+    {
+#ifdef RAYTRACER_SIMD
+        return simd::make(simd::load(*this) + simd::load(other));
+#else
+        return Tuple(x + other.x, y + other.y, z + other.z, w + other.w);
+#endif
+    }
+
+    inline Tuple Tuple::operator-(const Tuple &other) const
+    {
+#ifdef RAYTRACER_SIMD
+        return simd::make(simd::load(*this) - simd::load(other));
+#else
+        return Tuple(x - other.x, y - other.y, z - other.z, w - other.w);
+#endif
+    }
+
+    inline Tuple Tuple::operator-() const
+    {
+#ifdef RAYTRACER_SIMD
+        return simd::make(simd::load(*this) * simd::broadcast(-1));
+#else
+        return Tuple(-x, -y, -z, -w);
+#endif
+    }
+
+    inline Tuple Tuple::operator*(double scalar) const
+    {
+#ifdef RAYTRACER_SIMD
+        return simd::make(simd::load(*this) * simd::broadcast(scalar));
+#else
+        return Tuple(x * scalar, y * scalar, z * scalar, w * scalar);
+#endif
+    }
+
+    inline Tuple Tuple::operator/(double scalar) const
+    {
+#ifdef RAYTRACER_SIMD
+        return simd::make(simd::load(*this) / simd::broadcast(scalar));
+#else
+        return Tuple(x / scalar, y / scalar, z / scalar, w / scalar);
+#endif
+    }
+
+    inline double Tuple::magnitude() const
+    {
+#ifdef RAYTRACER_SIMD
+        simd::double4 v = simd::load(*this);
+        return std::sqrt(simd::sum(v * v));
+#else
+        return std::sqrt(x * x + y * y + z * z + w * w);
+#endif
+    }
+
+    inline Tuple Tuple::normalize() const
+    {
+#ifdef RAYTRACER_SIMD
+        simd::double4 v = simd::load(*this);
+        return simd::make(v * simd::broadcast(1.0 / std::sqrt(simd::sum(v * v))));
+#else
+        double mag = magnitude();
+        return Tuple(x / mag, y / mag, z / mag, w / mag);
+#endif
+    }
+
+    inline double Tuple::dot(const Tuple &other) const
+    {
+#ifdef RAYTRACER_SIMD
+        return simd::sum(simd::load(*this) * simd::load(other));
+#else
+        return x * other.x + y * other.y + z * other.z + w * other.w;
+#endif
+    }
+
+    inline Tuple Tuple::cross(const Tuple &other) const
+    {
+#ifdef RAYTRACER_SIMD
+        simd::double4 a = simd::load(*this);
+        simd::double4 b = simd::load(other);
+        return simd::make(simd::xyz0(simd::yzxw(a) * simd::zxyw(b) - simd::zxyw(a) * simd::yzxw(b)));
+#else
+        return Tuple(y * other.z - z * other.y, z * other.x - x * other.z, x * other.y - y * other.x, 0.0);
+#endif
+    }
+
 } // namespace raytracer
 
 std::ostream &operator<<(std::ostream &, const raytracer::Tuple &);
@@ -7,7 +7,7 @@ namespace raytracer {
     class Vector : public Tuple {
     public:
         Vector(double x, double y, double z);
-        virtual ~Vector() = default;
+        ~Vector() = default;
 
         Vector(const Vector &) = default;
         Vector &operator=(const Vector &) = default;
@@ -15,6 +15,9 @@ namespace raytracer {
         Vector(Vector &&) = default;
         Vector &operator=(Vector &&) = default;
     };
+
+    static_assert(sizeof(Vector) == sizeof(Tuple), "Vector must not add state to Tuple");
+    static_assert(std::is_trivially_copyable_v<Vector>);
 } // namespace raytracer
 
 #endif // __VECTOR_HPP__
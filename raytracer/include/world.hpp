@@ -6,6 +6,7 @@
 namespace raytracer {
     class Shape;
     class PointLight;
+    class Intersection;
     class Intersections;
     class Computations;
     class Ray;
@@ -33,8 +34,17 @@ namespace raytracer {
         PointLight *&light() { return m_light; }
         PointLight *const &light() const { return m_light; }
 
+    public:
+        // Bakes the transforms of every group into the shapes below it, so
+        // that rendering transforms each ray once per primitive and each
+        // normal once, however deep the hierarchy. Holds until the next
+        // setTransform or Group::add anywhere, after which shapes go back to
+        // walking their parents until commit() is called again.
+        void commit();
+
     public:
         Intersections intersect(const Ray &ray) const;
+        std::optional<Intersection> closestHit(const Ray &ray, double tmin, double tmax) const;
         Color shadeHit(const Computations &comps, int remaining = 5) const;
         Color colorAt(const Ray &ray, int remaining = 5) const;
         bool isShadowed(const Point &point) const;
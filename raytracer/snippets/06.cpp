@@ -12,7 +12,7 @@ int main()
     world.shapes().push_back(floor);
 
     raytracer::Sphere *middle = new raytracer::Sphere();
-    middle->transform() = raytracer::Matrix::translation(-0.5, 1, 0.5);
+    middle->setTransform(raytracer::Matrix4::translation(-0.5, 1, 0.5));
     middle->material() = raytracer::Material();
     middle->material().color() = raytracer::Color(0.1, 1, 0.5);
     middle->material().diffuse() = 0.7;
@@ -20,7 +20,7 @@ int main()
     world.shapes().push_back(middle);
 
     raytracer::Sphere *right = new raytracer::Sphere();
-    right->transform() = raytracer::Matrix::translation(1.5, 0.5, -0.5) * raytracer::Matrix::scaling(0.5, 0.5, 0.5);
+    right->setTransform(raytracer::Matrix4::translation(1.5, 0.5, -0.5) * raytracer::Matrix4::scaling(0.5, 0.5, 0.5));
     right->material() = raytracer::Material();
     right->material().color() = raytracer::Color(0.5, 1, 0.1);
     right->material().diffuse() = 0.7;
@@ -28,7 +28,7 @@ int main()
     world.shapes().push_back(right);
 
     raytracer::Sphere *left = new raytracer::Sphere();
-    left->transform() = raytracer::Matrix::translation(-1.5, 0.33, -0.75) * raytracer::Matrix::scaling(0.33, 0.33, 0.33);
+    left->setTransform(raytracer::Matrix4::translation(-1.5, 0.33, -0.75) * raytracer::Matrix4::scaling(0.33, 0.33, 0.33));
     left->material() = raytracer::Material();
     left->material().color() = raytracer::Color(1, 0.8, 0.1);
     left->material().diffuse() = 0.7;
@@ -36,7 +36,7 @@ int main()
     world.shapes().push_back(left);
 
     raytracer::Camera camera(1024, 1024, M_PI / 3);
-    camera.transform = raytracer::Matrix::viewTransform(raytracer::Point(0, 1.5, -5), raytracer::Point(0, 1, 0), raytracer::Vector(0, 1, 0));
+    camera.setTransform(raytracer::Matrix4::viewTransform(raytracer::Point(0, 1.5, -5), raytracer::Point(0, 1, 0), raytracer::Vector(0, 1, 0)));
 
     raytracer::Canvas canvas = camera.render(world);
 
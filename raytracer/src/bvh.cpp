@@ -0,0 +1,272 @@
+#include "bvh.hpp"
+
+#include <cmath>
+
+using namespace raytracer;
+
+// Rounds a bound outwards to the nearest float so the node box never shrinks
+// below the double precision box it was built from.
+static float lowerFloat(double value)
+{
+    float f = static_cast<float>(value);
+    return f > value ? std::nextafter(f, -std::numeric_limits<float>::infinity()) : f;
+}
+
+static float upperFloat(double value)
+{
+    float f = static_cast<float>(value);
+    return f < value ? std::nextafter(f, std::numeric_limits<float>::infinity()) : f;
+}
+
+void LinearBVH::build(const std::vector<Bounds> &bounds, int maxLeafSize)
+{
+    m_maxLeafSize = std::max(1, maxLeafSize);
+    m_nodes.clear();
+    m_indices.clear();
+
+    // Bounds and centroids are computed once up front; the split search only
+    // reads them back.
+    std::vector<Primitive> primitives;
+    primitives.reserve(bounds.size());
+    for (std::size_t i = 0; i < bounds.size(); ++i)
+        primitives.push_back({bounds[i], bounds[i].center(), static_cast<std::uint32_t>(i)});
+
+    if (primitives.empty())
+        return;
+
+    m_nodes.reserve(2 * primitives.size());
+    buildNode(primitives, 0, primitives.size(), 0);
+    m_nodes.shrink_to_fit();
+
+    m_indices.reserve(primitives.size());
+    for (const auto &primitive : primitives)
+        m_indices.push_back(primitive.index);
+}
+
+void LinearBVH::assign(std::vector<Node> nodes, std::vector<std::uint32_t> indices)
+{
+    m_nodes = std::move(nodes);
+    m_indices = std::move(indices);
+}
+
+Bounds LinearBVH::bounds() const
+{
+    if (m_nodes.empty())
+        return Bounds(Point(0, 0, 0), Point(0, 0, 0));
+    const Node &root = m_nodes[0];
+    return Bounds(Point(root.min[0], root.min[1], root.min[2]), Point(root.max[0], root.max[1], root.max[2]));
+}
+
+std::uint32_t LinearBVH::buildNode(std::vector<Primitive> &primitives, std::size_t begin, std::size_t end, int depth)
+{
+    Bounds bounds = Bounds::Empty();
+    Bounds centroids = Bounds::Empty();
+    for (std::size_t i = begin; i < end; ++i) {
+        bounds += primitives[i].bounds;
+        centroids += primitives[i].centroid;
+    }
+
+    std::uint32_t index = static_cast<std::uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+    {
+        Node &node = m_nodes[index];
+        for (int axis = 0; axis < 3; ++axis) {
+            node.min[axis] = lowerFloat(bounds.min[axis]);
+            node.max[axis] = upperFloat(bounds.max[axis]);
+        }
+    }
+
+    std::size_t count = end - begin;
+
+    // Split along the axis where the centroids are spread the most.
+    Vector extent = centroids.size();
+    int axis = 0;
+    if (extent.y > extent[axis])
+        axis = 1;
+    if (extent.z > extent[axis])
+        axis = 2;
+
+    if (count <= static_cast<std::size_t>(m_maxLeafSize) || extent[axis] <= 0) {
+        m_nodes[index].offset = static_cast<std::uint32_t>(begin);
+        m_nodes[index].count = static_cast<std::uint32_t>(count);
+        return index;
+    }
+
+    // Drop every centroid into one of BinCount buckets along the axis.
+    struct Bin {
+        std::size_t count = 0;
+        Bounds bounds = Bounds::Empty();
+    };
+    Bin bins[BinCount];
+
+    double origin = centroids.min[axis];
+    double scale = BinCount / extent[axis];
+    auto binOf = [&](const Primitive &p) {
+        int b = static_cast<int>((p.centroid[axis] - origin) * scale);
+        return std::min(b, BinCount - 1);
+    };
+
+    for (std::size_t i = begin; i < end; ++i) {
+        Bin &bin = bins[binOf(primitives[i])];
+        bin.bounds += primitives[i].bounds;
+        bin.count++;
+    }
+
+    // Sweep from the right to get the area and count of every suffix, then
+    // from the left to evaluate the cost of splitting after each bin.
+    double rightArea[BinCount];
+    std::size_t rightCount[BinCount];
+    {
+        Bounds acc = Bounds::Empty();
+        std::size_t n = 0;
+        for (int i = BinCount - 1; i > 0; --i) {
+            acc += bins[i].bounds;
+            n += bins[i].count;
+            rightCount[i] = n;
+            rightArea[i] = n == 0 ? 0 : acc.surfaceArea();
+        }
+    }
+
+    // Past half the stack depth, fall back to median splits: the remaining
+    // levels are then bounded by log2(count) and traversal cannot overflow.
+    int bestSplit = -1;
+    double bestCost = std::numeric_limits<double>::infinity();
+    if (depth < MaxDepth / 2) {
+        Bounds acc = Bounds::Empty();
+        std::size_t n = 0;
+        for (int i = 0; i < BinCount - 1; ++i) {
+            acc += bins[i].bounds;
+            n += bins[i].count;
+            if (n == 0 || rightCount[i + 1] == 0)
+                continue;
+            double cost = n * acc.surfaceArea() + rightCount[i + 1] * rightArea[i + 1];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestSplit = i;
+            }
+        }
+    }
+
+    std::size_t middle;
+    if (bestSplit < 0) {
+        middle = begin + count / 2;
+        std::nth_element(primitives.begin() + begin, primitives.begin() + middle, primitives.begin() + end, [axis](const Primitive &a, const Primitive &b) {
+            return a.centroid[axis] < b.centroid[axis];
+        });
+    } else {
+        auto it = std::partition(primitives.begin() + begin, primitives.begin() + end, [&](const Primitive &p) {
+            return binOf(p) <= bestSplit;
+        });
+        middle = it - primitives.begin();
+    }
+
+    // The left subtree lands right after this node; only the right child
+    // needs to be recorded.
+    buildNode(primitives, begin, middle, depth + 1);
+    std::uint32_t right = buildNode(primitives, middle, end, depth + 1);
+    m_nodes[index].offset = right;
+    m_nodes[index].count = 0;
+    return index;
+}
+
+bool LinearBVH::intersectNode(const Node &node, const double origin[3], const double invDirection[3], double &tmin, double &tmax)
+{
+    // Slab test. Boxes behind the origin are still reported; callers that
+    // do not want them compare tmax against their own lower bound.
+    tmax = std::numeric_limits<double>::infinity();
+    tmin = -std::numeric_limits<double>::infinity();
+    for (int axis = 0; axis < 3; ++axis) {
+        double t0 = (node.min[axis] - origin[axis]) * invDirection[axis];
+        double t1 = (node.max[axis] - origin[axis]) * invDirection[axis];
+        if (t0 > t1)
+            std::swap(t0, t1);
+        tmin = t0 > tmin ? t0 : tmin;
+        tmax = t1 < tmax ? t1 : tmax;
+    }
+    return tmin <= tmax;
+}
+
+BVH::BVH(std::vector<Shape *> shapes, int maxLeafSize)
+    : AShape(), m_shapes(std::move(shapes)), m_tree()
+{
+    std::vector<Bounds> bounds;
+    bounds.reserve(m_shapes.size());
+    for (auto shape : m_shapes) {
+        bounds.push_back(shape->parentSpaceBounds());
+        static_cast<AShape *>(shape)->parent = this;
+    }
+    m_tree.build(bounds, maxLeafSize);
+    invalidateTransforms();
+}
+
+BVH::~BVH()
+{
+    for (auto shape : m_shapes)
+        delete shape;
+}
+
+Intersections BVH::localIntersect(const Ray &ray) const
+{
+    Intersections result;
+    double closest = std::numeric_limits<double>::infinity();
+    m_tree.traverse(treeRay(ray), closest, [&](std::uint32_t primitive, double &nearest) {
+        Intersections xs = m_shapes[primitive]->intersect(ray);
+        for (std::size_t j = 0; j < xs.count(); ++j)
+            if (xs[j].t() >= 0 && xs[j].t() < nearest)
+                nearest = xs[j].t();
+        result.add(xs);
+    });
+    return result;
+}
+
+bool BVH::localOccluded(const Ray &ray, double tmax) const
+{
+    return m_tree.any(treeRay(ray), tmax, [&](std::uint32_t primitive) {
+        return m_shapes[primitive]->occluded(ray, tmax);
+    });
+}
+
+std::optional<Intersection> BVH::localClosestHit(const Ray &ray, double tmin, double tmax) const
+{
+    std::optional<Intersection> hit;
+    m_tree.traverse(treeRay(ray), tmin, tmax, [&](std::uint32_t primitive, double &nearest) {
+        if (auto h = m_shapes[primitive]->closestHit(ray, tmin, nearest)) {
+            hit = h;
+            nearest = h->t();
+        }
+    });
+    return hit;
+}
+
+Vector BVH::localNormalAt(const Point &) const
+{
+    throw std::runtime_error("BVH::localNormalAt should never be called.");
+}
+
+Bounds BVH::bounds() const
+{
+    return m_tree.bounds();
+}
+
+void BVH::commit(const Matrix4 &parentInverse)
+{
+    AShape::commit(parentInverse);
+    m_passThrough = true;
+    for (auto shape : m_shapes)
+        shape->commit(m_worldInverse);
+}
+
+Ray BVH::treeRay(const Ray &ray) const
+{
+    return committed() ? ray.transform(m_worldInverse) : ray;
+}
+
+std::size_t BVH::size() const
+{
+    return m_shapes.size();
+}
+
+const LinearBVH &BVH::tree() const
+{
+    return m_tree;
+}
@@ -5,47 +5,131 @@
 #include "vector.hpp"
 #include "world.hpp"
 
-// #include <progressbar/progressbar.h>
+#include <cassert>
+#include <thread>
 
 using namespace raytracer;
 
 Camera::Camera(int hsize, int vsize, double fieldOfView)
-    : hsize(hsize), vsize(vsize), fieldOfView(fieldOfView), halfView(std::tan(fieldOfView / 2)), aspect(static_cast<double>(hsize) / static_cast<double>(vsize)), halfWidth(aspect >= 1 ? halfView : halfView * aspect), halfHeight(aspect >= 1 ? halfView / aspect : halfView), pixelSize((halfWidth * 2) / hsize), transform(Matrix::identity(4))
+    : hsize(hsize), vsize(vsize), fieldOfView(fieldOfView), halfView(std::tan(fieldOfView / 2)), aspect(static_cast<double>(hsize) / static_cast<double>(vsize)), halfWidth(aspect >= 1 ? halfView : halfView * aspect), halfHeight(aspect >= 1 ? halfView / aspect : halfView), pixelSize((halfWidth * 2) / hsize), m_transform(Matrix4::identity()), m_inverse(Matrix4::identity()), m_origin(0, 0, 0)
 
 {
 }
 
+void Camera::setTransform(const Matrix4 &transform)
+{
+    assert(transform.isInvertible());
+    m_transform = transform;
+    m_inverse = transform.inverse();
+    Tuple origin = m_inverse * Point(0, 0, 0);
+    m_origin = Point(origin.x, origin.y, origin.z);
+}
+
 Ray Camera::rayForPixel(int px, int py) const
 {
-    if (px < 0 || px >= hsize || py < 0 || py >= vsize)
-        throw std::out_of_range("Pixel coordinates out of bounds.");
+    assert(px >= 0 && px < hsize && py >= 0 && py < vsize);
 
     const double xOffset = (px + 0.5) * pixelSize;
     const double yOffset = (py + 0.5) * pixelSize;
     const double xWorld = halfWidth - xOffset;
     const double yWorld = halfHeight - yOffset;
-    const Tuple pixel = transform.inverse() * Point(xWorld, yWorld, -1);
-    const Tuple origin = transform.inverse() * Point(0, 0, 0);
-    const Vector direction = (pixel - origin).normalize().asVector();
-    return Ray(origin, direction);
+    const Tuple pixel = m_inverse * Point(xWorld, yWorld, -1);
+    const Vector direction = (pixel - m_origin).normalize().asVector();
+    return Ray(m_origin, direction);
 }
 
-Canvas Camera::render(const World &world, ProgressBar *pb) const
+void Camera::generateRays(const Tile &tile, std::span<double> dx, std::span<double> dy, std::span<double> dz) const
 {
+    assert(dx.size() >= static_cast<std::size_t>(tile.pixels()));
+    assert(dy.size() >= static_cast<std::size_t>(tile.pixels()));
+    assert(dz.size() >= static_cast<std::size_t>(tile.pixels()));
 
-    Canvas image(hsize, vsize);
-
-#pragma omp parallel for
-    for (int y = 0; y < vsize; y++) {
-#pragma omp parallel for
-        for (int x = 0; x < hsize; x++) {
-            Ray r = rayForPixel(x, y);
-            Color c = world.colorAt(r);
-            image.writePixel(x, y, c);
-            if (pb)
-                pb->tick();
+    // The pixel on the canvas at z = -1 maps to
+    //   inverse * (xWorld, yWorld, -1, 1) = corner + xWorld * column0 + yWorld * column1
+    // so the direction before normalization is affine in the pixel position
+    // and each row is a plain loop over independent lanes.
+    const Matrix4 &m = m_inverse;
+    const double cx = m[0][3] - m[0][2] - m_origin.x;
+    const double cy = m[1][3] - m[1][2] - m_origin.y;
+    const double cz = m[2][3] - m[2][2] - m_origin.z;
+
+    std::size_t i = 0;
+    for (int py = tile.y0; py < tile.y1; ++py) {
+        const double yWorld = halfHeight - (py + 0.5) * pixelSize;
+        const double rx = cx + yWorld * m[0][1];
+        const double ry = cy + yWorld * m[1][1];
+        const double rz = cz + yWorld * m[2][1];
+
+        const std::size_t row = i;
+        for (int px = tile.x0; px < tile.x1; ++px, ++i) {
+            const double xWorld = halfWidth - (px + 0.5) * pixelSize;
+            dx[i] = rx + xWorld * m[0][0];
+            dy[i] = ry + xWorld * m[1][0];
+            dz[i] = rz + xWorld * m[2][0];
+        }
+
+        for (std::size_t j = row; j < i; ++j) {
+            const double scale = 1 / std::sqrt(dx[j] * dx[j] + dy[j] * dy[j] + dz[j] * dz[j]);
+            dx[j] *= scale;
+            dy[j] *= scale;
+            dz[j] *= scale;
         }
     }
+}
+
+Canvas Camera::render(const World &world, ProgressReporter *progress) const
+{
+    return render(world, RenderOptions(), progress);
+}
+
+Canvas Camera::render(const World &world, const RenderOptions &options, ProgressReporter *progress) const
+{
+    Canvas image(hsize, vsize, options.format);
+
+    // Round tiles up to whole cache lines of the canvas rows so that no two
+    // threads ever write into the same line.
+    int alignment = image.tileAlignment();
+    int tileSize = options.tileSize > 0 ? (options.tileSize + alignment - 1) / alignment * alignment : options.tileSize;
+    TileScheduler scheduler(hsize, vsize, tileSize, options.order);
+
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    (void)threads; // unused when built without OpenMP
+
+    if (progress)
+        progress->start(static_cast<std::size_t>(hsize) * vsize, threads);
+    std::atomic<int> nextThread{0};
+
+    // One parallel region for the whole frame; each thread keeps claiming
+    // the next tile until the scheduler runs dry, so fast tiles do not leave
+    // threads idle and each thread works on a compact block of pixels.
+#pragma omp parallel num_threads(threads)
+    {
+        int thread = nextThread.fetch_add(1, std::memory_order_relaxed);
+        std::size_t capacity = static_cast<std::size_t>(tileSize) * tileSize;
+        std::vector<double> directions(3 * capacity);
+        std::span<double> dx(directions.data(), capacity);
+        std::span<double> dy(directions.data() + capacity, capacity);
+        std::span<double> dz(directions.data() + 2 * capacity, capacity);
+
+        Tile tile;
+        while (scheduler.next(tile)) {
+            generateRays(tile, dx, dy, dz);
+            CanvasView view = image.tile(tile);
+            std::size_t i = 0;
+            for (int y = 0; y < view.height(); y++) {
+                for (int x = 0; x < view.width(); x++, i++) {
+                    Ray r(m_origin, Vector(dx[i], dy[i], dz[i]));
+                    Color c = world.colorAt(r);
+                    view.writePixel(x, y, c);
+                }
+            }
+            if (progress)
+                progress->add(thread, tile.pixels());
+        }
+    }
+
+    if (progress)
+        progress->finish();
 
     return image;
 }
@@ -1,18 +1,101 @@
 #include "canvas.hpp"
+#include "image_writer.hpp"
+#include "tile_scheduler.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <numeric>
 
 using namespace raytracer;
 
-Canvas::Canvas(int width, int height)
-    : m_width(width), m_height(height)
+std::size_t raytracer::bytesPerPixel(PixelFormat format)
 {
-    for (int y = 0; y < m_height; y++) {
-        std::vector<Color> row;
-        for (int x = 0; x < m_width; x++)
-            row.push_back(Color(0, 0, 0));
-        m_pixels.push_back(row);
+    switch (format) {
+    case PixelFormat::RGB32F:
+        return 3 * sizeof(float);
+    case PixelFormat::RGBA32F:
+        return 4 * sizeof(float);
+    case PixelFormat::RGB64F:
+        return 3 * sizeof(double);
+    }
+    return 0;
+}
+
+static Color loadPixel(const std::byte *p, PixelFormat format)
+{
+    if (format == PixelFormat::RGB64F) {
+        double c[3];
+        std::memcpy(c, p, sizeof(c));
+        return Color(c[0], c[1], c[2]);
+    }
+    float c[3];
+    std::memcpy(c, p, sizeof(c));
+    return Color(c[0], c[1], c[2]);
+}
+
+static void storePixel(std::byte *p, PixelFormat format, const Color &color)
+{
+    switch (format) {
+    case PixelFormat::RGB32F: {
+        float c[3] = {static_cast<float>(color.red()), static_cast<float>(color.green()), static_cast<float>(color.blue())};
+        std::memcpy(p, c, sizeof(c));
+        break;
+    }
+    case PixelFormat::RGBA32F: {
+        float c[4] = {static_cast<float>(color.red()), static_cast<float>(color.green()), static_cast<float>(color.blue()), 1.0f};
+        std::memcpy(p, c, sizeof(c));
+        break;
+    }
+    case PixelFormat::RGB64F: {
+        double c[3] = {color.red(), color.green(), color.blue()};
+        std::memcpy(p, c, sizeof(c));
+        break;
+    }
     }
 }
 
+CanvasView::CanvasView(std::byte *origin, std::size_t stride, PixelFormat format, int width, int height)
+    : m_origin(origin), m_stride(stride), m_format(format), m_width(width), m_height(height)
+{
+}
+
+Color CanvasView::pixelAt(int x, int y) const
+{
+    assert(x >= 0 && x < m_width && y >= 0 && y < m_height);
+    return loadPixel(data(y) + x * bytesPerPixel(m_format), m_format);
+}
+
+void CanvasView::writePixel(int x, int y, const Color &color)
+{
+    assert(x >= 0 && x < m_width && y >= 0 && y < m_height);
+    storePixel(data(y) + x * bytesPerPixel(m_format), m_format, color);
+}
+
+Canvas::Canvas(int width, int height, PixelFormat format)
+    : m_width(width), m_height(height), m_format(format), m_stride(0), m_pixels()
+{
+    std::size_t row = static_cast<std::size_t>(std::max(0, m_width)) * bytesPerPixel(m_format);
+    m_stride = (row + CacheLine - 1) / CacheLine * CacheLine;
+    std::size_t size = m_stride * std::max(0, m_height);
+    m_pixels.reset(new (std::align_val_t(CacheLine)) std::byte[size]);
+    std::memset(m_pixels.get(), 0, size);
+}
+
+Canvas::Canvas(const Canvas &other)
+    : m_width(other.m_width), m_height(other.m_height), m_format(other.m_format), m_stride(other.m_stride), m_pixels()
+{
+    std::size_t size = m_stride * std::max(0, m_height);
+    m_pixels.reset(new (std::align_val_t(CacheLine)) std::byte[size]);
+    std::memcpy(m_pixels.get(), other.m_pixels.get(), size);
+}
+
+Canvas &Canvas::operator=(const Canvas &other)
+{
+    if (this != &other)
+        *this = Canvas(other);
+    return *this;
+}
+
 int Canvas::width() const
 {
     return m_width;
@@ -23,14 +106,39 @@ int Canvas::height() const
     return m_height;
 }
 
+PixelFormat Canvas::format() const
+{
+    return m_format;
+}
+
 Color Canvas::pixelAt(int x, int y) const
 {
-    return m_pixels[y][x];
+    assert(x >= 0 && x < m_width && y >= 0 && y < m_height);
+    return loadPixel(data(y) + x * bytesPerPixel(m_format), m_format);
 }
 
 void Canvas::writePixel(int x, int y, const Color &color)
 {
-    m_pixels[y][x] = color;
+    assert(x >= 0 && x < m_width && y >= 0 && y < m_height);
+    storePixel(m_pixels.get() + y * m_stride + x * bytesPerPixel(m_format), m_format, color);
+}
+
+int Canvas::tileAlignment() const
+{
+    return static_cast<int>(CacheLine / std::gcd(CacheLine, bytesPerPixel(m_format)));
+}
+
+CanvasView Canvas::row(int y)
+{
+    assert(y >= 0 && y < m_height);
+    return CanvasView(m_pixels.get() + y * m_stride, m_stride, m_format, m_width, 1);
+}
+
+CanvasView Canvas::tile(const Tile &tile)
+{
+    assert(tile.x0 >= 0 && tile.x1 <= m_width && tile.y0 >= 0 && tile.y1 <= m_height);
+    std::byte *origin = m_pixels.get() + tile.y0 * m_stride + tile.x0 * bytesPerPixel(m_format);
+    return CanvasView(origin, m_stride, m_format, tile.width(), tile.height());
 }
 
 void Canvas::drawCircle(int x, int y, int radius, const Color &color)
@@ -49,54 +157,36 @@ void Canvas::drawCircle(int x, int y, int radius, const Color &color)
 
 std::string Canvas::toPPM() const
 {
-    std::stringstream ss;
-    ss << "P3" << std::endl;
-    ss << m_width << " " << m_height << std::endl;
-    ss << "255" << std::endl;
+    std::string ppm = "P3\n" + std::to_string(m_width) + " " + std::to_string(m_height) + "\n255\n";
+    ppm.reserve(ppm.size() + static_cast<std::size_t>(m_width) * m_height * 12);
 
+    // Lines never exceed 70 characters; a row always starts a new line.
     for (int y = 0; y < m_height; y++) {
-        std::list<std::string> colors;
+        std::size_t lineStart = ppm.size();
         for (int x = 0; x < m_width; x++) {
             Color c = pixelAt(x, y);
-
-            int r = static_cast<int>(std::max(0.0, std::min(255.0, std::floor(c.red() * 256))));
-            int g = static_cast<int>(std::max(0.0, std::min(255.0, std::floor(c.green() * 256))));
-            int b = static_cast<int>(std::max(0.0, std::min(255.0, std::floor(c.blue() * 256))));
-
-            colors.push_back(std::to_string(r));
-            colors.push_back(std::to_string(g));
-            colors.push_back(std::to_string(b));
-        }
-
-        std::string color;
-        std::stringstream line;
-
-        color = colors.front();
-        colors.pop_front();
-
-        line << color;
-
-        while (!colors.empty()) {
-            color = colors.front();
-            colors.pop_front();
-
-            if (line.str().length() + color.length() + 1 > 70) {
-                ss << line.str() << std::endl;
-                line = std::stringstream();
-                line << color;
-            } else {
-                line << " " << color;
+            for (double channel : {c.red(), c.green(), c.blue()}) {
+                char value[4];
+                int n = static_cast<int>(std::max(0.0, std::min(255.0, std::floor(channel * 256))));
+                std::size_t length = std::to_chars(value, value + sizeof(value), n).ptr - value;
+                if (ppm.size() > lineStart) {
+                    if (ppm.size() - lineStart + 1 + length > 70) {
+                        ppm += '\n';
+                        lineStart = ppm.size();
+                    } else {
+                        ppm += ' ';
+                    }
+                }
+                ppm.append(value, length);
             }
         }
-        ss << line.str() << std::endl;
+        ppm += '\n';
     }
 
-    return ss.str();
+    return ppm;
 }
 
 void Canvas::savePPM(const std::string &filePath) const
 {
-    std::ofstream file(filePath);
-    file << toPPM();
-    file.close();
+    ImageWriter::Save(*this, filePath, ImageFormat::PPM);
 }
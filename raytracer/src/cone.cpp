@@ -16,22 +16,22 @@ Intersections Cone::localIntersect(const Ray &r) const
     double b = 2 * o.x * d.x - 2 * o.y * d.y + 2 * o.z * d.z;
 
     if (double_equals(a, 0) && double_equals(b, 0)) {
-        std::vector<Intersection> xs;
+        Intersections xs;
         intersectCaps(r, xs);
-        return Intersections(xs);
+        return xs;
     }
 
     double c = o.x * o.x - o.y * o.y + o.z * o.z;
 
     if (double_equals(a, 0) && !double_equals(b, 0)) {
         double t = -c / (2 * b);
-        std::vector<Intersection> xs;
-        xs.push_back(Intersection(t, *this));
+        Intersections xs;
+        xs.add(Intersection(t, *this));
         intersectCaps(r, xs);
-        return Intersections(xs);
+        return xs;
     }
 
-    std::vector<Intersection> xs;
+    Intersections xs;
 
     double discriminant = b * b - 4 * a * c;
     if (discriminant < 0)
@@ -42,14 +42,14 @@ Intersections Cone::localIntersect(const Ray &r) const
 
     double y0 = r.position(t0).y;
     if (y0 < maximum && y0 > minimum)
-        xs.emplace_back(t0, *this);
+        xs.add(Intersection(t0, *this));
 
     double y1 = r.position(t1).y;
     if (y1 < maximum && y1 > minimum)
-        xs.emplace_back(t1, *this);
+        xs.add(Intersection(t1, *this));
 
     intersectCaps(r, xs);
-    return Intersections(xs);
+    return xs;
 }
 
 Vector Cone::localNormalAt(const Point &p) const
@@ -81,7 +81,7 @@ bool Cone::checkCaps(const Ray &r, double t)
     return (x * x + z * z) <= std::abs(y);
 }
 
-void Cone::intersectCaps(const Ray &r, std::vector<Intersection> &xs) const
+void Cone::intersectCaps(const Ray &r, Intersections &xs) const
 {
     auto d = r.direction();
     auto o = r.origin();
@@ -95,11 +95,11 @@ void Cone::intersectCaps(const Ray &r, std::vector<Intersection> &xs) const
     // the ray with the plane at y=cone.minimum
     double t = (minimum - r.origin().y) / r.direction().y;
     if (checkCaps(r, t))
-        xs.push_back(Intersection(t, *this));
+        xs.add(Intersection(t, *this));
 
     // Check for an intersection with the upper end cap by intersecting
     // the ray with the plane at y=cone.maximum
     t = (maximum - r.origin().y) / r.direction().y;
     if (checkCaps(r, t))
-        xs.push_back(Intersection(t, *this));
+        xs.add(Intersection(t, *this));
 }
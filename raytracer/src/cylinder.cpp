@@ -9,7 +9,7 @@ Cylinder::Cylinder()
 
 Intersections Cylinder::localIntersect(const Ray &r) const
 {
-    std::vector<Intersection> xs;
+    Intersections xs;
     intersectCaps(r, xs);
 
     auto d = r.direction();
@@ -33,13 +33,13 @@ Intersections Cylinder::localIntersect(const Ray &r) const
 
     double y0 = o.y + t0 * d.y;
     if (minimum < y0 && y0 < maximum)
-        xs.push_back(Intersection(t0, *this));
+        xs.add(Intersection(t0, *this));
 
     double y1 = o.y + t1 * d.y;
     if (minimum < y1 && y1 < maximum)
-        xs.push_back(Intersection(t1, *this));
+        xs.add(Intersection(t1, *this));
 
-    return Intersections(xs);
+    return xs;
 }
 
 Vector Cylinder::localNormalAt(const Point &p) const
@@ -72,7 +72,7 @@ bool Cylinder::checkCaps(const Ray &r, double t)
     return (x * x + z * z) <= std::abs(1);
 }
 
-void Cylinder::intersectCaps(const Ray &r, std::vector<Intersection> &xs) const
+void Cylinder::intersectCaps(const Ray &r, Intersections &xs) const
 {
     auto d = r.direction();
     auto o = r.origin();
@@ -86,11 +86,11 @@ void Cylinder::intersectCaps(const Ray &r, std::vector<Intersection> &xs) const
     // the ray with the plane at y=cylinder.minimum
     double t = (minimum - o.y) / d.y;
     if (checkCaps(r, t))
-        xs.push_back(Intersection(t, *this));
+        xs.add(Intersection(t, *this));
 
     // Check for an intersection with the upper end cap by intersecting
     // the ray with the plane at y=cylinder.maximum
     t = (maximum - o.y) / d.y;
     if (checkCaps(r, t))
-        xs.push_back(Intersection(t, *this));
+        xs.add(Intersection(t, *this));
 }
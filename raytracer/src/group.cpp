@@ -7,7 +7,7 @@ Shape *Group::Hexagon()
     auto hexagonSide = []() -> Shape * {
         auto hexagonCorner = []() -> Shape * {
             auto corner = new Sphere();
-            corner->transform() = Matrix::translation(0, 0, -1) * Matrix::scaling(0.25, 0.25, 0.25);
+            corner->setTransform(Matrix4::translation(0, 0, -1) * Matrix4::scaling(0.25, 0.25, 0.25));
             return corner;
         };
 
@@ -15,7 +15,7 @@ Shape *Group::Hexagon()
             auto edge = new Cylinder();
             edge->minimum = 0;
             edge->maximum = 1;
-            edge->transform() = Matrix::translation(0, 0, -1) * Matrix::rotationY(-M_PI / 6) * Matrix::rotationZ(-M_PI / 2) * Matrix::scaling(0.25, 1, 0.25);
+            edge->setTransform(Matrix4::translation(0, 0, -1) * Matrix4::rotationY(-M_PI / 6) * Matrix4::rotationZ(-M_PI / 2) * Matrix4::scaling(0.25, 1, 0.25));
             return edge;
         };
 
@@ -28,7 +28,7 @@ Shape *Group::Hexagon()
     auto hex = new Group();
     for (int i = 0; i < 6; ++i) {
         auto side = hexagonSide();
-        side->transform() = Matrix::rotationY(i * M_PI / 3);
+        side->setTransform(Matrix4::rotationY(i * M_PI / 3));
         hex->add(side);
     }
 
@@ -36,7 +36,7 @@ Shape *Group::Hexagon()
 }
 
 Group::Group()
-    : AShape()
+    : AShape(), m_boundsEpoch(0), m_bounds(Bounds::Empty()), m_worldBounds(Bounds::Empty())
 {
 }
 
@@ -56,16 +56,39 @@ Intersections Group::localIntersect(const Ray &ray) const
 {
     Intersections intersections;
 
-    // check if the ray intersects the bounding box of the group
-    // if (!bounds().intersect(ray))
-    //     return intersections;
+    // Every intersection counts here, behind the origin included.
+    if (misses(ray, -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()))
+        return intersections;
 
     for (const auto &shape : m_shapes)
-        intersections += shape->intersect(ray);
-    intersections.sort();
+        intersections.merge(shape->intersect(ray));
     return intersections;
 }
 
+bool Group::localOccluded(const Ray &ray, double tmax) const
+{
+    if (misses(ray, 0, tmax))
+        return false;
+    for (const auto &shape : m_shapes)
+        if (shape->occluded(ray, tmax))
+            return true;
+    return false;
+}
+
+std::optional<Intersection> Group::localClosestHit(const Ray &ray, double tmin, double tmax) const
+{
+    std::optional<Intersection> hit;
+    if (misses(ray, tmin, tmax))
+        return hit;
+    for (const auto &shape : m_shapes) {
+        if (auto h = shape->closestHit(ray, tmin, tmax)) {
+            hit = h;
+            tmax = h->t();
+        }
+    }
+    return hit;
+}
+
 Vector Group::localNormalAt(const Point &) const
 {
     return Vector(0, 0, 0);
@@ -73,22 +96,48 @@ Vector Group::localNormalAt(const Point &) const
 
 Bounds Group::bounds() const
 {
-    Bounds bounds = m_shapes[0]->bounds();
+    std::uint64_t epoch = transformEpoch();
+    if (m_boundsEpoch.load(std::memory_order_acquire) != epoch) {
+        std::lock_guard<std::mutex> lock(m_boundsMutex);
+        if (m_boundsEpoch.load(std::memory_order_relaxed) != epoch) {
+            Bounds bounds = Bounds::Empty();
+            for (const auto &shape : m_shapes)
+                bounds += shape->parentSpaceBounds();
+            m_bounds = bounds;
+            m_boundsEpoch.store(epoch, std::memory_order_release);
+        }
+    }
+    return m_bounds;
+}
+
+void Group::commit(const Matrix4 &parentInverse)
+{
+    AShape::commit(parentInverse);
+    m_passThrough = true;
+    m_worldBounds = bounds().transform(m_worldInverse.inverse());
     for (const auto &shape : m_shapes)
-        bounds += shape->bounds();
-    return bounds;
+        shape->commit(m_worldInverse);
+}
+
+bool Group::misses(const Ray &ray, double tmin, double tmax) const
+{
+    Bounds box = committed() ? m_worldBounds : bounds();
+    double t0, t1;
+    return box.empty() || !box.intersect(ray, t0, t1) || t0 >= tmax || t1 < tmin;
 }
 
 void Group::add(Shape *shape)
 {
     m_shapes.push_back(shape);
     reinterpret_cast<AShape *>(shape)->parent = this;
+    invalidateTransforms();
 }
 
 void Group::remove(Shape *shape)
 {
     m_shapes.erase(std::remove(m_shapes.begin(), m_shapes.end(), shape), m_shapes.end());
     delete shape;
+    invalidateTransforms();
 }
 
 bool Group::empty() const
@@ -0,0 +1,374 @@
+#include "image_writer.hpp"
+#include "canvas.hpp"
+
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <unistd.h>
+
+using namespace raytracer;
+
+namespace {
+
+    // Buffered writer on a raw file descriptor. Large blocks bypass the
+    // buffer; everything else is copied and written out 64 KiB at a time.
+    class Output {
+    public:
+        static constexpr std::size_t Capacity = 1 << 16;
+
+        explicit Output(int fd)
+            : m_fd(fd), m_size(0), m_written(0)
+        {
+        }
+
+        void put(const void *data, std::size_t size)
+        {
+            if (m_size + size > Capacity)
+                flush();
+            if (size >= Capacity) {
+                raw(data, size);
+                return;
+            }
+            std::memcpy(m_buffer + m_size, data, size);
+            m_size += size;
+        }
+
+        void flush()
+        {
+            raw(m_buffer, m_size);
+            m_size = 0;
+        }
+
+        std::size_t written() const { return m_written + m_size; }
+
+    private:
+        void raw(const void *data, std::size_t size)
+        {
+            const unsigned char *p = static_cast<const unsigned char *>(data);
+            while (size > 0) {
+                ssize_t n = ::write(m_fd, p, size);
+                if (n < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    throw std::runtime_error(std::string("ImageWriter: write failed: ") + std::strerror(errno));
+                }
+                p += n;
+                size -= n;
+                m_written += n;
+            }
+        }
+
+        int m_fd;
+        std::size_t m_size;
+        std::size_t m_written;
+        unsigned char m_buffer[Capacity];
+    };
+
+    // PNG chunk whose length is known up front; the CRC is accumulated as
+    // the data goes by so the chunk never has to be held in memory.
+    class Chunk {
+    public:
+        Chunk(Output &out, const char *type, std::uint32_t length)
+            : m_out(out), m_crc(0)
+        {
+            unsigned char header[8];
+            storeBigEndian(header, length);
+            std::memcpy(header + 4, type, 4);
+            m_out.put(header, 8);
+            m_crc = ImageWriter::Crc32(type, 4);
+        }
+
+        void put(const void *data, std::size_t size)
+        {
+            m_out.put(data, size);
+            m_crc = ImageWriter::Crc32(data, size, m_crc);
+        }
+
+        void end()
+        {
+            unsigned char crc[4];
+            storeBigEndian(crc, m_crc);
+            m_out.put(crc, 4);
+        }
+
+        static void storeBigEndian(unsigned char *p, std::uint32_t value)
+        {
+            p[0] = value >> 24;
+            p[1] = value >> 16;
+            p[2] = value >> 8;
+            p[3] = value;
+        }
+
+    private:
+        Output &m_out;
+        std::uint32_t m_crc;
+    };
+
+} // namespace
+
+// floor(c * 256) clamped to [0, 255] without the libm call: truncation is
+// floor for the positive values that are left once the ends are clamped.
+static unsigned char quantize(double c)
+{
+    double v = c * 256;
+    if (!(v < 255.0))
+        return 255;
+    return v > 0 ? static_cast<unsigned char>(v) : 0;
+}
+
+template <typename T>
+static void rowToBytes(const std::byte *p, std::size_t step, int width, unsigned char *out)
+{
+    for (int x = 0; x < width; ++x, p += step, out += 3) {
+        T c[3];
+        std::memcpy(c, p, sizeof(c));
+        out[0] = quantize(c[0]);
+        out[1] = quantize(c[1]);
+        out[2] = quantize(c[2]);
+    }
+}
+
+// Converts row y to 8-bit RGB.
+static void rowToBytes(const Canvas &canvas, int y, unsigned char *out)
+{
+    std::size_t step = bytesPerPixel(canvas.format());
+    if (canvas.format() == PixelFormat::RGB64F)
+        rowToBytes<double>(canvas.data(y), step, canvas.width(), out);
+    else
+        rowToBytes<float>(canvas.data(y), step, canvas.width(), out);
+}
+
+// Converts row y to 32-bit float RGB.
+static void rowToFloats(const Canvas &canvas, int y, float *out)
+{
+    const std::byte *p = canvas.data(y);
+    std::size_t step = bytesPerPixel(canvas.format());
+    for (int x = 0; x < canvas.width(); ++x, p += step, out += 3) {
+        if (canvas.format() == PixelFormat::RGB64F) {
+            double c[3];
+            std::memcpy(c, p, sizeof(c));
+            out[0] = static_cast<float>(c[0]), out[1] = static_cast<float>(c[1]), out[2] = static_cast<float>(c[2]);
+        } else {
+            std::memcpy(out, p, 3 * sizeof(float));
+        }
+    }
+}
+
+std::size_t ImageWriter::WritePPM(const Canvas &canvas, int fd)
+{
+    Output out(fd);
+    std::string header = "P6\n" + std::to_string(canvas.width()) + " " + std::to_string(canvas.height()) + "\n255\n";
+    out.put(header.data(), header.size());
+
+    std::vector<unsigned char> row(3 * static_cast<std::size_t>(canvas.width()));
+    for (int y = 0; y < canvas.height(); ++y) {
+        rowToBytes(canvas, y, row.data());
+        out.put(row.data(), row.size());
+    }
+    out.flush();
+    return out.written();
+}
+
+std::size_t ImageWriter::WritePFM(const Canvas &canvas, int fd)
+{
+    // A negative scale marks little-endian samples; rows go bottom to top.
+    Output out(fd);
+    const char *scale = std::endian::native == std::endian::little ? "-1.0" : "1.0";
+    std::string header = "PF\n" + std::to_string(canvas.width()) + " " + std::to_string(canvas.height()) + "\n" + scale + "\n";
+    out.put(header.data(), header.size());
+
+    std::size_t size = 3 * sizeof(float) * canvas.width();
+    std::vector<float> row(3 * static_cast<std::size_t>(canvas.width()));
+    for (int y = canvas.height() - 1; y >= 0; --y) {
+        if (canvas.format() == PixelFormat::RGB32F) {
+            out.put(canvas.data(y), size);
+        } else {
+            rowToFloats(canvas, y, row.data());
+            out.put(row.data(), size);
+        }
+    }
+    out.flush();
+    return out.written();
+}
+
+std::size_t ImageWriter::WritePNG(const Canvas &canvas, int fd)
+{
+    // Stored deflate blocks carry at most 65535 bytes each; every block
+    // goes out as its own IDAT chunk, the first one opening the zlib
+    // stream and the last one closing it with the Adler-32 of the
+    // filtered scanlines.
+    static constexpr std::size_t MaxStored = 65535;
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+    Output out(fd);
+    out.put(signature, sizeof(signature));
+
+    unsigned char header[13] = {};
+    Chunk::storeBigEndian(header, canvas.width());
+    Chunk::storeBigEndian(header + 4, canvas.height());
+    header[8] = 8; // bits per channel
+    header[9] = 2; // truecolor RGB
+    Chunk ihdr(out, "IHDR", sizeof(header));
+    ihdr.put(header, sizeof(header));
+    ihdr.end();
+
+    std::size_t scanline = 1 + 3 * static_cast<std::size_t>(canvas.width());
+    std::size_t total = scanline * canvas.height();
+    std::size_t blocks = std::max<std::size_t>(1, (total + MaxStored - 1) / MaxStored);
+
+    std::vector<unsigned char> row(scanline, 0); // row[0] is filter type 0, none
+    std::size_t offset = scanline;
+    int y = 0;
+    std::uint32_t adler = 1;
+
+    for (std::size_t block = 0; block < blocks; ++block) {
+        bool first = block == 0;
+        bool last = block + 1 == blocks;
+        std::size_t length = std::min(MaxStored, total - block * MaxStored);
+
+        Chunk idat(out, "IDAT", static_cast<std::uint32_t>((first ? 2 : 0) + 5 + length + (last ? 4 : 0)));
+        if (first) {
+            static const unsigned char zlib[2] = {0x78, 0x01}; // deflate, 32K window, no dictionary
+            idat.put(zlib, sizeof(zlib));
+        }
+        unsigned char stored[5] = {
+            static_cast<unsigned char>(last),
+            static_cast<unsigned char>(length),
+            static_cast<unsigned char>(length >> 8),
+            static_cast<unsigned char>(~length),
+            static_cast<unsigned char>(~length >> 8),
+        };
+        idat.put(stored, sizeof(stored));
+
+        while (length > 0) {
+            if (offset == scanline) {
+                rowToBytes(canvas, y++, row.data() + 1);
+                offset = 0;
+            }
+            std::size_t n = std::min(length, scanline - offset);
+            idat.put(row.data() + offset, n);
+            adler = Adler32(row.data() + offset, n, adler);
+            offset += n;
+            length -= n;
+        }
+
+        if (last) {
+            unsigned char checksum[4];
+            Chunk::storeBigEndian(checksum, adler);
+            idat.put(checksum, sizeof(checksum));
+        }
+        idat.end();
+    }
+
+    Chunk(out, "IEND", 0).end();
+    out.flush();
+    return out.written();
+}
+
+std::size_t ImageWriter::Write(const Canvas &canvas, int fd, ImageFormat format)
+{
+    switch (format) {
+    case ImageFormat::PPM:
+        return WritePPM(canvas, fd);
+    case ImageFormat::PFM:
+        return WritePFM(canvas, fd);
+    case ImageFormat::PNG:
+        return WritePNG(canvas, fd);
+    }
+    return 0;
+}
+
+std::size_t ImageWriter::Save(const Canvas &canvas, const std::string &filePath)
+{
+    return Save(canvas, filePath, FormatForPath(filePath));
+}
+
+std::size_t ImageWriter::Save(const Canvas &canvas, const std::string &filePath, ImageFormat format)
+{
+    int fd = ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        throw std::runtime_error("ImageWriter: cannot open " + filePath + ": " + std::strerror(errno));
+
+    std::size_t written;
+    try {
+        written = Write(canvas, fd, format);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    if (::close(fd) < 0)
+        throw std::runtime_error("ImageWriter: cannot close " + filePath + ": " + std::strerror(errno));
+    return written;
+}
+
+ImageFormat ImageWriter::FormatForPath(const std::string &filePath)
+{
+    auto endsWith = [&](const char *extension) {
+        std::size_t n = std::strlen(extension);
+        return filePath.size() >= n && filePath.compare(filePath.size() - n, n, extension) == 0;
+    };
+    if (endsWith(".ppm"))
+        return ImageFormat::PPM;
+    if (endsWith(".pfm"))
+        return ImageFormat::PFM;
+    if (endsWith(".png"))
+        return ImageFormat::PNG;
+    throw std::invalid_argument("ImageWriter: unknown image extension: " + filePath);
+}
+
+// Slicing-by-8 tables: table[0] is the classic byte table, table[k] the
+// CRC of a byte followed by k zero bytes, so eight bytes fold in per step.
+static constexpr std::array<std::array<std::uint32_t, 256>, 8> crcTables()
+{
+    std::array<std::array<std::uint32_t, 256>, 8> table{};
+    for (std::uint32_t n = 0; n < 256; ++n) {
+        std::uint32_t c = n;
+        for (int k = 0; k < 8; ++k)
+            c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+        table[0][n] = c;
+    }
+    for (std::uint32_t n = 0; n < 256; ++n)
+        for (int k = 1; k < 8; ++k)
+            table[k][n] = table[0][table[k - 1][n] & 0xff] ^ (table[k - 1][n] >> 8);
+    return table;
+}
+
+std::uint32_t ImageWriter::Crc32(const void *data, std::size_t size, std::uint32_t value)
+{
+    static constexpr auto table = crcTables();
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    std::uint32_t c = value ^ 0xffffffffu;
+    for (; size >= 8; size -= 8, p += 8) {
+        std::uint32_t lo = c ^ (p[0] | p[1] << 8 | p[2] << 16 | static_cast<std::uint32_t>(p[3]) << 24);
+        c = table[7][lo & 0xff] ^ table[6][(lo >> 8) & 0xff] ^ table[5][(lo >> 16) & 0xff] ^ table[4][lo >> 24] ^
+            table[3][p[4]] ^ table[2][p[5]] ^ table[1][p[6]] ^ table[0][p[7]];
+    }
+    for (; size > 0; --size)
+        c = table[0][(c ^ *p++) & 0xff] ^ (c >> 8);
+    return c ^ 0xffffffffu;
+}
+
+std::uint32_t ImageWriter::Adler32(const void *data, std::size_t size, std::uint32_t value)
+{
+    // 5552 is the longest run before b can overflow 32 bits, so the modulo
+    // only runs once per run.
+    static constexpr std::uint32_t Base = 65521;
+    static constexpr std::size_t Run = 5552;
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    std::uint32_t a = value & 0xffff;
+    std::uint32_t b = value >> 16;
+    while (size > 0) {
+        std::size_t n = std::min(size, Run);
+        size -= n;
+        for (; n > 0; --n) {
+            a += *p++;
+            b += a;
+        }
+        a %= Base;
+        b %= Base;
+    }
+    return (b << 16) | a;
+}
@@ -11,7 +11,7 @@ std::ostream &operator<<(std::ostream &os, const raytracer::Computations &comps)
 }
 
 Computations::Computations(const Intersection &intersection, const Ray &ray)
-    : t(intersection.t()), shape(intersection.shape()), point(ray.position(t).asPoint()), eyev((-ray.direction()).asVector()), normalv(shape.normalAt(point).asVector()), inside(false), overPoint((point + normalv * EPSILON).asPoint()), reflectv(ray.direction().reflect(normalv).asVector()), n1(0.0), n2(0.0), underPoint((point - normalv * EPSILON).asPoint())
+    : t(intersection.t()), shape(intersection.shape()), point(ray.position(t).asPoint()), eyev((-ray.direction()).asVector()), normalv(shape.normalAt(point, intersection).asVector()), inside(false), overPoint((point + normalv * EPSILON).asPoint()), reflectv(ray.direction().reflect(normalv).asVector()), n1(0.0), n2(0.0), underPoint((point - normalv * EPSILON).asPoint())
 {
     if (normalv.dot(eyev) < 0) {
         inside = true;
@@ -45,8 +45,13 @@ double Computations::schlick() const
     return r0 + (1 - r0) * std::pow(1 - cos, 5);
 }
 
-Intersection::Intersection(double t, const Shape &shape)
-    : m_t(t), m_shape(&shape)
+Intersection::Intersection(double t, const Shape &shape, std::uint32_t primitive)
+    : m_t(t), m_shape(&shape), m_primitive(primitive), m_u(0), m_v(0)
+{
+}
+
+Intersection::Intersection(double t, const Shape &shape, double u, double v, std::uint32_t primitive)
+    : m_t(t), m_shape(&shape), m_primitive(primitive), m_u(u), m_v(v)
 {
 }
 
@@ -55,37 +60,49 @@ bool Intersection::operator==(const Intersection &other) const
     return m_t == other.m_t && &m_shape == &other.m_shape;
 }
 
-Computations Intersection::prepareComputations(const Ray &ray, const Intersections &xs) const
+void ContainerTracker::toggle(const Shape &shape)
 {
-    Computations comps(*this, ray);
-    std::vector<const Shape *> containers;
+    // The innermost container is the likeliest one to be left next, so the
+    // search runs from the top of the stack.
+    for (std::size_t i = m_stack.size(); i > 0; --i) {
+        if (m_stack[i - 1] == &shape) {
+            m_stack.erase(m_stack.begin() + i - 1);
+            return;
+        }
+    }
+    m_stack.push_back(&shape);
+}
 
-    const Intersection *hit = this;
+double ContainerTracker::refractiveIndex() const
+{
+    return m_stack.empty() ? 1.0 : m_stack.back()->material().refractiveIndex;
+}
 
-    xs.forEachIntersection([&](const Intersection &i) {
-        if (hit == &i) {
-            if (containers.empty()) {
-                comps.n1 = 1.0;
-            } else {
-                comps.n1 = containers.back()->material().refractiveIndex;
-            }
-        }
-        auto it = std::find(containers.begin(), containers.end(), &i.shape());
-        if (it != containers.end()) {
-            containers.erase(it);
-        } else {
-            containers.push_back(&i.shape());
+Computations Intersection::prepareComputations(const Ray &ray, const Intersections &xs) const
+{
+    Computations comps(*this, ray);
+    ContainerTracker containers;
+
+    // Only the intersections up to the hit matter; stop there.
+    for (std::size_t index = 0; index < xs.count(); ++index) {
+        const Intersection &i = xs[index];
+        if (&i == this) {
+            comps.n1 = containers.refractiveIndex();
+            containers.toggle(i.shape());
+            comps.n2 = containers.refractiveIndex();
+            break;
         }
+        containers.toggle(i.shape());
+    }
 
-        if (hit == &i) {
-            if (containers.empty()) {
-                comps.n2 = 1.0;
-            } else {
-                comps.n2 = containers.back()->material().refractiveIndex;
-            }
-        }
-    });
+    return comps;
+}
 
+Computations Intersection::prepareComputations(const Ray &ray) const
+{
+    Computations comps(*this, ray);
+    comps.n1 = 1.0;
+    comps.n2 = 1.0;
     return comps;
 }
 
@@ -109,8 +126,11 @@ Intersections::Intersections(std::initializer_list<Intersection> intersections)
 }
 
 Intersections::Intersections(std::vector<Intersection> intersections)
-    : m_intersections(intersections)
+    : m_intersections()
 {
+    m_intersections.reserve(intersections.size());
+    for (const auto &i : intersections)
+        m_intersections.push_back(i);
 }
 
 Intersections &Intersections::operator+=(const Intersections &other)
@@ -139,6 +159,12 @@ const Intersection *Intersections::hit() const
     return hit;
 }
 
+Intersections &Intersections::add(const Intersection &intersection)
+{
+    m_intersections.push_back(intersection);
+    return *this;
+}
+
 Intersections &Intersections::add(const Intersections &other)
 {
     for (const auto &i : other.m_intersections)
@@ -148,28 +174,44 @@ Intersections &Intersections::add(const Intersections &other)
 
 Intersections &Intersections::sort()
 {
-    typedef std::function<bool(const Intersection &, const Intersection &)> Compare;
-
-    std::priority_queue<Intersection, std::vector<Intersection>, Compare> pq(
-        [](const Intersection &a, const Intersection &b) {
-            return a.t() > b.t();
+    // Rays hit a handful of surfaces, where insertion sort beats anything
+    // with more setup; long lists from big unsorted groups go to std::sort.
+    std::size_t n = m_intersections.size();
+    if (n > 16) {
+        std::sort(m_intersections.begin(), m_intersections.end(), [](const Intersection &a, const Intersection &b) {
+            return a.t() < b.t();
         });
-
-    while (m_intersections.empty() == false) {
-        pq.push(m_intersections.back());
-        m_intersections.pop_back();
+        return *this;
     }
 
-    while (pq.empty() == false) {
-        m_intersections.push_back(pq.top());
-        pq.pop();
+    for (std::size_t i = 1; i < n; ++i) {
+        Intersection x = m_intersections[i];
+        std::size_t j = i;
+        for (; j > 0 && m_intersections[j - 1].t() > x.t(); --j)
+            m_intersections[j] = m_intersections[j - 1];
+        m_intersections[j] = x;
     }
+    return *this;
+}
 
+Intersections &Intersections::insert(const Intersection &intersection)
+{
+    Intersection x = intersection;
+    m_intersections.push_back(x);
+    std::size_t j = m_intersections.size() - 1;
+    for (; j > 0 && m_intersections[j - 1].t() > x.t(); --j)
+        m_intersections[j] = m_intersections[j - 1];
+    m_intersections[j] = x;
     return *this;
 }
 
-void Intersections::forEachIntersection(std::function<void(const Intersection &)> f) const
+Intersections &Intersections::merge(const Intersections &other)
 {
-    for (const auto &i : m_intersections)
-        f(i);
+    if (&other == this)
+        return merge(Intersections(other));
+
+    m_intersections.reserve(m_intersections.size() + other.m_intersections.size());
+    for (const auto &i : other.m_intersections)
+        insert(i);
+    return *this;
 }
@@ -0,0 +1,45 @@
+#include "mapped_file.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace raytracer;
+
+MappedFile::MappedFile(const std::string &filePath)
+    : m_data(nullptr), m_size(0)
+{
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("cannot open " + filePath + ": " + std::strerror(errno));
+
+    struct stat info;
+    if (::fstat(fd, &info) < 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error("cannot stat " + filePath + ": " + std::strerror(error));
+    }
+
+    m_size = static_cast<std::size_t>(info.st_size);
+    if (m_size > 0) {
+        void *data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            int error = errno;
+            ::close(fd);
+            throw std::runtime_error("cannot map " + filePath + ": " + std::strerror(error));
+        }
+        ::madvise(data, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char *>(data);
+    }
+    ::close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+        ::munmap(const_cast<char *>(m_data), m_size);
+}
@@ -124,6 +124,11 @@ double *Matrix::operator[](std::size_t row)
     return m_matrix[row];
 }
 
+const double *Matrix::operator[](std::size_t row) const
+{
+    return m_matrix[row];
+}
+
 bool Matrix::operator==(const Matrix &other) const
 {
     if (m_rows != other.m_rows || m_cols != other.m_cols)
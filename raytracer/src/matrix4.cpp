@@ -0,0 +1,65 @@
+#include "matrix4.hpp"
+
+#include <cassert>
+
+using namespace raytracer;
+
+Matrix4 Matrix4::translation(double x, double y, double z)
+{
+    return Matrix4(Matrix::translation(x, y, z));
+}
+
+Matrix4 Matrix4::scaling(double x, double y, double z)
+{
+    return Matrix4(Matrix::scaling(x, y, z));
+}
+
+Matrix4 Matrix4::rotationX(double radians)
+{
+    return Matrix4(Matrix::rotationX(radians));
+}
+
+Matrix4 Matrix4::rotationY(double radians)
+{
+    return Matrix4(Matrix::rotationY(radians));
+}
+
+Matrix4 Matrix4::rotationZ(double radians)
+{
+    return Matrix4(Matrix::rotationZ(radians));
+}
+
+Matrix4 Matrix4::shearing(double xy, double xz, double yx, double yz, double zx, double zy)
+{
+    return Matrix4(Matrix::shearing(xy, xz, yx, yz, zx, zy));
+}
+
+Matrix4 Matrix4::viewTransform(const Tuple &from, const Tuple &to, const Tuple &up)
+{
+    return Matrix4(Matrix::viewTransform(from, to, up));
+}
+
+Matrix4::Matrix4(const Matrix &other)
+    : m_matrix{}
+{
+    assert(other.rows() == 4 && other.cols() == 4);
+    for (size_t i = 0; i < 4; ++i)
+        for (size_t j = 0; j < 4; ++j)
+            m_matrix[i][j] = other[i][j];
+}
+
+Matrix4::operator Matrix() const
+{
+    return Matrix(4, 4, const_cast<double *>(&m_matrix[0][0]));
+}
+
+bool Matrix4::operator==(const Matrix4 &other) const
+{
+    for (size_t i = 0; i < 4; ++i)
+        for (size_t j = 0; j < 4; ++j)
+            if (double_equals(m_matrix[i][j], other.m_matrix[i][j]) == false)
+                return false;
+
+    return true;
+}
+
@@ -0,0 +1,267 @@
+#include "mesh_cache.hpp"
+#include "mapped_file.hpp"
+
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <unistd.h>
+
+using namespace raytracer;
+
+namespace {
+
+    constexpr char Magic[8] = {'R', 'T', 'M', 'E', 'S', 'H', '\r', '\n'};
+    constexpr std::uint32_t ByteOrder = 0x01020304;
+    constexpr std::uint64_t Alignment = 64;
+    constexpr std::uint64_t Prime = 0x100000001b3ull;
+
+    enum SectionId {
+        Positions,
+        Texcoords,
+        Normals,
+        PositionIndices,
+        TexcoordIndices,
+        NormalIndices,
+        Nodes,
+        NodeIndices,
+        SectionCount,
+    };
+
+    struct Section {
+        std::uint64_t offset; // from the start of the file
+        std::uint64_t count;  // elements, not bytes
+    };
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        std::uint64_t key;
+        std::uint64_t fileSize;
+        Section sections[SectionCount];
+    };
+
+    static_assert(std::is_trivially_copyable_v<Header> && std::is_trivially_copyable_v<LinearBVH::Node>);
+
+    constexpr std::size_t elementSize[SectionCount] = {
+        sizeof(double),
+        sizeof(double),
+        sizeof(double),
+        sizeof(std::uint32_t),
+        sizeof(std::uint32_t),
+        sizeof(std::uint32_t),
+        sizeof(LinearBVH::Node),
+        sizeof(std::uint32_t),
+    };
+
+    std::uint64_t alignUp(std::uint64_t offset)
+    {
+        return (offset + Alignment - 1) & ~(Alignment - 1);
+    }
+
+    // Writes everything or throws, retrying short writes and EINTR.
+    void writeAll(int fd, const void *data, std::size_t size, const std::string &filePath)
+    {
+        const char *p = static_cast<const char *>(data);
+        while (size > 0) {
+            ssize_t n = ::write(fd, p, size);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw std::runtime_error("MeshCache: cannot write " + filePath + ": " + std::strerror(errno));
+            }
+            p += n;
+            size -= n;
+        }
+    }
+
+    template <typename T>
+    std::vector<T> readSection(const char *base, const Section &section)
+    {
+        std::vector<T> values(section.count);
+        if (section.count > 0)
+            std::memcpy(values.data(), base + section.offset, section.count * sizeof(T));
+        return values;
+    }
+
+} // namespace
+
+TriangleMesh MeshCache::LoadFile(const std::string &objFilePath, int maxLeafSize)
+{
+    return LoadFile(objFilePath, objFilePath + Extension, maxLeafSize);
+}
+
+TriangleMesh MeshCache::LoadFile(const std::string &objFilePath, const std::string &cachePath, int maxLeafSize)
+{
+    std::unique_ptr<MappedFile> source;
+    try {
+        source = std::make_unique<MappedFile>(objFilePath);
+    } catch (const std::runtime_error &error) {
+        throw std::runtime_error(std::string("MeshCache: ") + error.what());
+    }
+
+    std::uint64_t key = Key(source->view(), maxLeafSize);
+    if (std::optional<TriangleMesh> cached = Load(cachePath, key))
+        return std::move(*cached);
+
+    TriangleMesh mesh(OBJLoader::Parse(source->view()), maxLeafSize);
+    try {
+        Save(mesh, cachePath, key);
+    } catch (const std::runtime_error &) {
+        // Read-only directory or full disk: the mesh is still good.
+    }
+    return mesh;
+}
+
+std::optional<TriangleMesh> MeshCache::Load(const std::string &cachePath, std::uint64_t key)
+{
+    std::unique_ptr<MappedFile> file;
+    try {
+        file = std::make_unique<MappedFile>(cachePath);
+    } catch (const std::runtime_error &) {
+        return std::nullopt;
+    }
+
+    Header header;
+    if (file->size() < sizeof(header))
+        return std::nullopt;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version || header.byteOrder != ByteOrder)
+        return std::nullopt;
+    if (header.key != key || header.fileSize != file->size())
+        return std::nullopt;
+
+    for (int id = 0; id < SectionCount; ++id) {
+        const Section &section = header.sections[id];
+        if (section.offset % Alignment != 0 || section.offset < sizeof(header) || section.offset > file->size())
+            return std::nullopt;
+        if (section.count > (file->size() - section.offset) / elementSize[id])
+            return std::nullopt;
+    }
+
+    // The arrays must describe a mesh; their contents are trusted once the
+    // key matches.
+    const Section *sections = header.sections;
+    std::uint64_t corners = sections[PositionIndices].count;
+    if (sections[Positions].count % 3 || sections[Texcoords].count % 2 || sections[Normals].count % 3 || corners % 3)
+        return std::nullopt;
+    if ((sections[TexcoordIndices].count && sections[TexcoordIndices].count != corners) || (sections[NormalIndices].count && sections[NormalIndices].count != corners))
+        return std::nullopt;
+    if (sections[NodeIndices].count != corners / 3 || (sections[Nodes].count == 0) != (corners == 0))
+        return std::nullopt;
+
+    const char *base = file->data();
+    MeshData mesh;
+    mesh.positions = readSection<double>(base, sections[Positions]);
+    mesh.texcoords = readSection<double>(base, sections[Texcoords]);
+    mesh.normals = readSection<double>(base, sections[Normals]);
+    mesh.positionIndices = readSection<std::uint32_t>(base, sections[PositionIndices]);
+    mesh.texcoordIndices = readSection<std::uint32_t>(base, sections[TexcoordIndices]);
+    mesh.normalIndices = readSection<std::uint32_t>(base, sections[NormalIndices]);
+
+    LinearBVH tree;
+    tree.assign(readSection<LinearBVH::Node>(base, sections[Nodes]), readSection<std::uint32_t>(base, sections[NodeIndices]));
+    return TriangleMesh(std::move(mesh), std::move(tree));
+}
+
+void MeshCache::Save(const TriangleMesh &mesh, const std::string &cachePath, std::uint64_t key)
+{
+    const MeshData &data = mesh.mesh();
+    const void *arrays[SectionCount] = {
+        data.positions.data(),
+        data.texcoords.data(),
+        data.normals.data(),
+        data.positionIndices.data(),
+        data.texcoordIndices.data(),
+        data.normalIndices.data(),
+        mesh.tree().nodes().data(),
+        mesh.tree().indices().data(),
+    };
+
+    Header header = {};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.byteOrder = ByteOrder;
+    header.key = key;
+    header.sections[Positions].count = data.positions.size();
+    header.sections[Texcoords].count = data.texcoords.size();
+    header.sections[Normals].count = data.normals.size();
+    header.sections[PositionIndices].count = data.positionIndices.size();
+    header.sections[TexcoordIndices].count = data.texcoordIndices.size();
+    header.sections[NormalIndices].count = data.normalIndices.size();
+    header.sections[Nodes].count = mesh.tree().nodes().size();
+    header.sections[NodeIndices].count = mesh.tree().indices().size();
+
+    std::uint64_t offset = alignUp(sizeof(header));
+    for (int id = 0; id < SectionCount; ++id) {
+        header.sections[id].offset = offset;
+        offset = alignUp(offset + header.sections[id].count * elementSize[id]);
+    }
+    header.fileSize = offset;
+
+    std::string temporary = cachePath + ".tmp" + std::to_string(::getpid());
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        throw std::runtime_error("MeshCache: cannot open " + temporary + ": " + std::strerror(errno));
+
+    try {
+        static const char padding[Alignment] = {};
+        std::uint64_t written = 0;
+        auto put = [&](const void *bytes, std::size_t size) {
+            writeAll(fd, bytes, size, temporary);
+            written += size;
+        };
+
+        put(&header, sizeof(header));
+        for (int id = 0; id < SectionCount; ++id) {
+            put(padding, header.sections[id].offset - written);
+            put(arrays[id], header.sections[id].count * elementSize[id]);
+        }
+        put(padding, header.fileSize - written);
+
+        if (::close(fd) < 0) {
+            fd = -1;
+            throw std::runtime_error("MeshCache: cannot write " + temporary + ": " + std::strerror(errno));
+        }
+        fd = -1;
+        if (::rename(temporary.c_str(), cachePath.c_str()) < 0)
+            throw std::runtime_error("MeshCache: cannot rename " + temporary + " to " + cachePath + ": " + std::strerror(errno));
+    } catch (...) {
+        if (fd >= 0)
+            ::close(fd);
+        ::unlink(temporary.c_str());
+        throw;
+    }
+}
+
+std::uint64_t MeshCache::Key(std::string_view source, int maxLeafSize)
+{
+    // Anything that changes the bytes a build would write goes in.
+    const std::uint64_t parameters[] = {
+        Version,
+        static_cast<std::uint64_t>(std::max(1, maxLeafSize)),
+        static_cast<std::uint64_t>(LinearBVH::BinCount),
+        sizeof(LinearBVH::Node),
+        source.size(),
+    };
+    std::uint64_t value = Hash(parameters, sizeof(parameters));
+    return Hash(source.data(), source.size(), value);
+}
+
+std::uint64_t MeshCache::Hash(const void *data, std::size_t size, std::uint64_t value)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    for (; size >= 8; p += 8, size -= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, p, 8);
+        if constexpr (std::endian::native == std::endian::big)
+            word = __builtin_bswap64(word);
+        value = (value ^ word) * Prime;
+        value ^= value >> 32;
+    }
+    for (; size > 0; ++p, --size)
+        value = (value ^ *p) * Prime;
+    return value;
+}
@@ -4,51 +4,45 @@ using namespace raytracer;
 
 OBJFileParser OBJFileParser::ParseFile(const std::string &filePath)
 {
-    std::ifstream objFileStream(filePath);
-    std::stringstream objFileContent;
-    objFileContent << objFileStream.rdbuf();
-    return ParseString(objFileContent.str());
+    return FromMesh(OBJLoader::LoadFile(filePath));
 }
 
 OBJFileParser OBJFileParser::ParseString(const std::string &fileContent)
+{
+    return FromMesh(OBJLoader::Parse(fileContent));
+}
+
+OBJFileParser OBJFileParser::FromMesh(const MeshData &mesh)
 {
     std::vector<Point> vertices;
     std::vector<Vector> normals;
     std::vector<Triangle> faces;
+    std::vector<SmoothTriangle> smoothFaces;
+    std::vector<std::size_t> smoothIndices;
+
+    vertices.reserve(mesh.vertexCount());
+    for (std::size_t i = 0; i < mesh.vertexCount(); i++)
+        vertices.push_back(Point(mesh.positions[3 * i], mesh.positions[3 * i + 1], mesh.positions[3 * i + 2]));
+
+    normals.reserve(mesh.normalCount());
+    for (std::size_t i = 0; i < mesh.normalCount(); i++)
+        normals.push_back(Vector(mesh.normals[3 * i], mesh.normals[3 * i + 1], mesh.normals[3 * i + 2]));
+
+    for (std::size_t i = 0; i < mesh.triangleCount(); i++) {
+        auto p1 = vertices[mesh.positionIndices[3 * i]];
+        auto p2 = vertices[mesh.positionIndices[3 * i + 1]];
+        auto p3 = vertices[mesh.positionIndices[3 * i + 2]];
+
+        faces.push_back(Triangle(p1, p2, p3));
 
-    std::stringstream objFileStream(fileContent);
-    std::string line;
-    while (std::getline(objFileStream, line)) {
-        std::stringstream lineStream(line);
-        std::string lineType;
-        lineStream >> lineType;
-
-        if (lineType == "v") {
-            double x, y, z;
-            lineStream >> x >> y >> z;
-            vertices.push_back(Point(x, y, z));
-        } else if (lineType == "vn") {
-            double x, y, z;
-            lineStream >> x >> y >> z;
-            normals.push_back(Vector(x, y, z));
-        } else if (lineType == "f") {
-            std::vector<int> face;
-            std::string faceVertex;
-            while (lineStream >> faceVertex) {
-                std::stringstream faceVertexStream(faceVertex);
-                std::string faceVertexIndex;
-                std::getline(faceVertexStream, faceVertexIndex, '/');
-                face.push_back(std::stoi(faceVertexIndex));
-            }
-
-            for (int i = 2; i < face.size(); i++) {
-                auto p1 = vertices[face[0] - 1];
-                auto p2 = vertices[face[i - 1] - 1];
-                auto p3 = vertices[face[i] - 1];
-                faces.push_back(Triangle(p1, p2, p3));
-            }
+        const std::uint32_t *n = mesh.normalIndices.empty() ? nullptr : &mesh.normalIndices[3 * i];
+        if (n && n[0] != MeshData::None && n[1] != MeshData::None && n[2] != MeshData::None) {
+            smoothIndices.push_back(smoothFaces.size());
+            smoothFaces.push_back(SmoothTriangle(p1, p2, p3, normals[n[0]], normals[n[1]], normals[n[2]]));
+        } else {
+            smoothIndices.push_back(Flat);
         }
     }
 
-    return OBJFileParser(vertices, normals, faces);
+    return OBJFileParser(vertices, normals, faces, smoothFaces, smoothIndices);
 }
@@ -0,0 +1,370 @@
+#include "obj_loader.hpp"
+#include "mapped_file.hpp"
+#include "small_vector.hpp"
+
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+using namespace raytracer;
+
+namespace {
+
+    struct Corner {
+        std::uint32_t position, texcoord, normal;
+    };
+
+    // Indices at or above Relative, other than MeshData::None, are chunk
+    // relative: Relative + Bias + (records before the corner within the
+    // chunk) + (negative OBJ index). The offset past Relative + Bias goes
+    // negative when the index points back into an earlier chunk; it becomes
+    // absolute once the records of the earlier chunks are counted.
+    constexpr std::uint32_t Relative = 1u << 31;
+    constexpr long long Bias = 1ll << 30;
+
+    enum Kind { Position, Texcoord, Normal };
+
+    class Parser {
+    public:
+        // A chunked parser reads one piece of a larger file: positive
+        // indices are kept without a range check, negative ones are stored
+        // chunk relative, both to be resolved by fixupIndex.
+        explicit Parser(MeshData &mesh, bool chunked = false)
+            : m_mesh(mesh), m_line(0), m_chunked(chunked), m_reach{LLONG_MIN, LLONG_MIN, LLONG_MIN}, m_back{0, 0, 0}, m_texcoords(false), m_normals(false)
+        {
+        }
+
+        bool usesTexcoords() const { return m_texcoords; }
+        bool usesNormals() const { return m_normals; }
+
+        // Largest (positive index - records of its kind before it) seen in
+        // chunked mode; the chunk is valid if this stays below the number of
+        // records in the earlier chunks.
+        long long reach(int kind) const { return m_reach[kind]; }
+
+        // Largest number of records of its kind before the chunk that a
+        // negative index points back over; the chunk is valid if the
+        // earlier chunks hold at least that many.
+        long long back(int kind) const { return m_back[kind]; }
+
+        void parse(const char *p, const char *end)
+        {
+            while (p < end) {
+                const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+                if (!eol)
+                    eol = end;
+                ++m_line;
+                parseLine(p, eol);
+                p = eol + 1;
+            }
+        }
+
+    private:
+        static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+        static const char *skipSpaces(const char *p, const char *end)
+        {
+            while (p < end && isSpace(*p))
+                ++p;
+            return p;
+        }
+
+        [[noreturn]] void fail(const char *what) const
+        {
+            throw std::runtime_error("OBJLoader: line " + std::to_string(m_line) + ": " + what);
+        }
+
+        void parseLine(const char *p, const char *end)
+        {
+            p = skipSpaces(p, end);
+            if (end - p < 2)
+                return;
+
+            if (p[0] == 'v' && isSpace(p[1]))
+                parseNumbers(p + 2, end, m_mesh.positions, 3, 3);
+            else if (p[0] == 'v' && p[1] == 't' && end - p > 2 && isSpace(p[2]))
+                parseNumbers(p + 3, end, m_mesh.texcoords, 2, 1);
+            else if (p[0] == 'v' && p[1] == 'n' && end - p > 2 && isSpace(p[2]))
+                parseNumbers(p + 3, end, m_mesh.normals, 3, 3);
+            else if (p[0] == 'f' && isSpace(p[1]))
+                parseFace(p + 2, end);
+        }
+
+        // Appends `count` numbers of the record, zero for the missing ones
+        // past the first `required`. Anything after them (a vertex weight or
+        // a w texture coordinate) is ignored.
+        void parseNumbers(const char *p, const char *end, std::vector<double> &out, int count, int required)
+        {
+            for (int i = 0; i < count; ++i) {
+                double value = 0;
+                if (i < required || skipSpaces(p, end) < end)
+                    p = parseDouble(p, end, value);
+                out.push_back(value);
+            }
+        }
+
+        const char *parseDouble(const char *p, const char *end, double &value) const
+        {
+            p = skipSpaces(p, end);
+            if (p < end && *p == '+')
+                ++p;
+            auto [next, error] = std::from_chars(p, end, value);
+            if (error != std::errc())
+                fail("expected a number");
+            return next;
+        }
+
+        // 1-based or negative OBJ index to a 0-based index below `count`,
+        // the number of records of its kind read so far.
+        std::uint32_t resolve(long long index, std::size_t count, int kind)
+        {
+            if (m_chunked) {
+                // Records from earlier chunks are not counted yet: remember
+                // how far indices reach past this chunk's records, forwards
+                // and backwards, so the range check can be finished once
+                // they are.
+                if (index > 0) {
+                    if (index - 1 >= Relative)
+                        fail("index out of range");
+                    m_reach[kind] = std::max(m_reach[kind], index - 1 - static_cast<long long>(count));
+                    return static_cast<std::uint32_t>(index - 1);
+                }
+                long long offset = static_cast<long long>(count) + index;
+                if (index == 0 || offset < -Bias || offset >= Bias - 1)
+                    fail("index out of range");
+                m_back[kind] = std::max(m_back[kind], -offset);
+                return static_cast<std::uint32_t>(Relative + Bias + offset);
+            }
+            long long resolved = index > 0 ? index - 1 : static_cast<long long>(count) + index;
+            if (index == 0 || resolved < 0 || resolved >= static_cast<long long>(count))
+                fail("index out of range");
+            return static_cast<std::uint32_t>(resolved);
+        }
+
+        const char *parseIndex(const char *p, const char *end, std::size_t count, int kind, std::uint32_t &index)
+        {
+            long long value;
+            auto [next, error] = std::from_chars(p, end, value);
+            if (error != std::errc())
+                fail("expected an index");
+            index = resolve(value, count, kind);
+            return next;
+        }
+
+        void parseFace(const char *p, const char *end)
+        {
+            SmallVector<Corner, 8> corners;
+            while ((p = skipSpaces(p, end)) < end) {
+                Corner corner{0, MeshData::None, MeshData::None};
+                p = parseIndex(p, end, m_mesh.vertexCount(), Position, corner.position);
+                if (p < end && *p == '/') {
+                    ++p;
+                    if (p < end && *p != '/')
+                        p = parseIndex(p, end, m_mesh.texcoordCount(), Texcoord, corner.texcoord);
+                    if (p < end && *p == '/')
+                        p = parseIndex(p + 1, end, m_mesh.normalCount(), Normal, corner.normal);
+                }
+                if (p < end && !isSpace(*p))
+                    fail("malformed face vertex");
+                corners.push_back(corner);
+            }
+            if (corners.size() < 3)
+                fail("face with fewer than three vertices");
+
+            for (std::size_t i = 2; i < corners.size(); ++i)
+                addTriangle(corners[0], corners[i - 1], corners[i]);
+        }
+
+        void addTriangle(const Corner &a, const Corner &b, const Corner &c)
+        {
+            // The optional index arrays only appear once a face uses them,
+            // backfilled so they stay parallel to positionIndices.
+            if (!m_texcoords && (a.texcoord != MeshData::None || b.texcoord != MeshData::None || c.texcoord != MeshData::None)) {
+                m_mesh.texcoordIndices.assign(m_mesh.positionIndices.size(), MeshData::None);
+                m_texcoords = true;
+            }
+            if (!m_normals && (a.normal != MeshData::None || b.normal != MeshData::None || c.normal != MeshData::None)) {
+                m_mesh.normalIndices.assign(m_mesh.positionIndices.size(), MeshData::None);
+                m_normals = true;
+            }
+
+            for (const Corner *corner : {&a, &b, &c}) {
+                m_mesh.positionIndices.push_back(corner->position);
+                if (m_texcoords)
+                    m_mesh.texcoordIndices.push_back(corner->texcoord);
+                if (m_normals)
+                    m_mesh.normalIndices.push_back(corner->normal);
+            }
+        }
+
+        MeshData &m_mesh;
+        std::size_t m_line;
+        bool m_chunked;
+        long long m_reach[3];
+        long long m_back[3];
+        bool m_texcoords; // texcoordIndices is in use
+        bool m_normals;   // normalIndices is in use
+    };
+
+} // namespace
+
+// Makes a chunk index absolute given the records of its kind in the earlier
+// chunks (base) and in the whole file (total). False if it is out of range.
+static bool fixupIndex(std::uint32_t &index, std::size_t base, std::size_t total)
+{
+    if (index == MeshData::None)
+        return true;
+    long long absolute = index >= Relative ? static_cast<long long>(index) - Relative - Bias + static_cast<long long>(base) : index;
+    if (absolute < 0 || absolute >= static_cast<long long>(total))
+        return false;
+    index = static_cast<std::uint32_t>(absolute);
+    return true;
+}
+
+// Splits content into at most `count` pieces that each end on a newline.
+static std::vector<std::string_view> splitLines(std::string_view content, int count)
+{
+    std::vector<std::string_view> chunks;
+    std::size_t start = 0;
+    for (int i = 1; i <= count && start < content.size(); ++i) {
+        std::size_t end = i == count ? content.size() : std::max(start, content.size() * i / count);
+        end = std::min(content.find('\n', end), content.size() - 1) + 1;
+        if (end > start)
+            chunks.push_back(content.substr(start, end - start));
+        start = end;
+    }
+    return chunks;
+}
+
+// Parses the chunks independently, then concatenates them: a prefix sum
+// over the record and triangle counts gives every chunk its place in the
+// output and the base its relative indices are fixed up against. Returns
+// false on any error, which the caller reports by parsing serially.
+static bool parseChunks(const std::vector<std::string_view> &chunks, MeshData &mesh)
+{
+    struct Piece {
+        MeshData mesh;
+        bool texcoords = false, normals = false, ok = true;
+        long long reach[3] = {}, back[3] = {};
+        std::size_t vertexBase = 0, texcoordBase = 0, normalBase = 0, triangleBase = 0;
+    };
+    int count = static_cast<int>(chunks.size());
+    std::vector<Piece> pieces(count);
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int i = 0; i < count; ++i) {
+        try {
+            Parser parser(pieces[i].mesh, true);
+            parser.parse(chunks[i].data(), chunks[i].data() + chunks[i].size());
+            pieces[i].texcoords = parser.usesTexcoords();
+            pieces[i].normals = parser.usesNormals();
+            for (int kind : {Position, Texcoord, Normal}) {
+                pieces[i].reach[kind] = parser.reach(kind);
+                pieces[i].back[kind] = parser.back(kind);
+            }
+        } catch (const std::exception &) {
+            pieces[i].ok = false;
+        }
+    }
+
+    std::size_t vertices = 0, texcoords = 0, normals = 0, triangles = 0;
+    bool anyTexcoords = false, anyNormals = false;
+    for (Piece &piece : pieces) {
+        if (!piece.ok)
+            return false;
+        long long base[3] = {static_cast<long long>(vertices), static_cast<long long>(texcoords), static_cast<long long>(normals)};
+        for (int kind : {Position, Texcoord, Normal})
+            if (piece.reach[kind] >= base[kind] || piece.back[kind] > base[kind])
+                return false;
+        piece.vertexBase = vertices;
+        piece.texcoordBase = texcoords;
+        piece.normalBase = normals;
+        piece.triangleBase = triangles;
+        vertices += piece.mesh.vertexCount();
+        texcoords += piece.mesh.texcoordCount();
+        normals += piece.mesh.normalCount();
+        triangles += piece.mesh.triangleCount();
+        anyTexcoords |= piece.texcoords;
+        anyNormals |= piece.normals;
+    }
+
+    mesh.positions.resize(3 * vertices);
+    mesh.texcoords.resize(2 * texcoords);
+    mesh.normals.resize(3 * normals);
+    mesh.positionIndices.resize(3 * triangles);
+    mesh.texcoordIndices.resize(anyTexcoords ? 3 * triangles : 0);
+    mesh.normalIndices.resize(anyNormals ? 3 * triangles : 0);
+
+    bool ok = true;
+#pragma omp parallel for schedule(dynamic, 1) reduction(&& : ok)
+    for (int i = 0; i < count; ++i) {
+        const Piece &piece = pieces[i];
+        const MeshData &part = piece.mesh;
+        std::copy(part.positions.begin(), part.positions.end(), mesh.positions.begin() + 3 * piece.vertexBase);
+        std::copy(part.texcoords.begin(), part.texcoords.end(), mesh.texcoords.begin() + 2 * piece.texcoordBase);
+        std::copy(part.normals.begin(), part.normals.end(), mesh.normals.begin() + 3 * piece.normalBase);
+
+        std::size_t first = 3 * piece.triangleBase;
+        for (std::size_t j = 0; j < part.positionIndices.size(); ++j) {
+            std::uint32_t index = part.positionIndices[j];
+            ok = fixupIndex(index, piece.vertexBase, vertices) && ok;
+            mesh.positionIndices[first + j] = index;
+        }
+        if (anyTexcoords) {
+            for (std::size_t j = 0; j < part.positionIndices.size(); ++j) {
+                std::uint32_t index = piece.texcoords ? part.texcoordIndices[j] : MeshData::None;
+                ok = fixupIndex(index, piece.texcoordBase, texcoords) && ok;
+                mesh.texcoordIndices[first + j] = index;
+            }
+        }
+        if (anyNormals) {
+            for (std::size_t j = 0; j < part.positionIndices.size(); ++j) {
+                std::uint32_t index = piece.normals ? part.normalIndices[j] : MeshData::None;
+                ok = fixupIndex(index, piece.normalBase, normals) && ok;
+                mesh.normalIndices[first + j] = index;
+            }
+        }
+    }
+    return ok;
+}
+
+MeshData OBJLoader::LoadFile(const std::string &filePath, int chunks)
+{
+    std::unique_ptr<MappedFile> file;
+    try {
+        file = std::make_unique<MappedFile>(filePath);
+    } catch (const std::runtime_error &error) {
+        throw std::runtime_error(std::string("OBJLoader: ") + error.what());
+    }
+    return Parse(file->view(), chunks);
+}
+
+MeshData OBJLoader::Parse(std::string_view content, int chunks)
+{
+    if (chunks <= 0) {
+        // A single hardware thread would only pay for the stitching.
+        std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        chunks = threads == 1 ? 1 : static_cast<int>(std::min(4 * threads, content.size() / ChunkSize + 1));
+    }
+
+    if (chunks > 1) {
+        if (auto mesh = ParseChunks(content, chunks))
+            return std::move(*mesh);
+    }
+
+    // Serial parse: the only path for small files, and the one that
+    // reports errors with their line number.
+    MeshData mesh;
+    Parser(mesh).parse(content.data(), content.data() + content.size());
+    return mesh;
+}
+
+std::optional<MeshData> OBJLoader::ParseChunks(std::string_view content, int chunks)
+{
+    MeshData mesh;
+    if (!parseChunks(splitLines(content, chunks), mesh))
+        return std::nullopt;
+    return mesh;
+}
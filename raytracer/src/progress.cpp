@@ -0,0 +1,65 @@
+#include "progress.hpp"
+
+using namespace raytracer;
+
+ProgressReporter::ProgressReporter(Callback callback, std::chrono::milliseconds interval)
+    : m_callback(std::move(callback)), m_interval(interval), m_start(std::chrono::steady_clock::now()), m_total(0), m_counters(), m_threads(0), m_nextReport(0), m_reporting(false)
+{
+}
+
+void ProgressReporter::start(std::size_t total, int threads)
+{
+    m_threads = std::max(1, threads);
+    m_counters.reset(new Counter[m_threads]);
+    m_total = total;
+    m_start = std::chrono::steady_clock::now();
+    m_nextReport.store(m_interval.count(), std::memory_order_relaxed);
+}
+
+void ProgressReporter::add(int thread, std::size_t pixels)
+{
+    // Only this thread writes its counter, so a load and a store suffice.
+    Counter &counter = m_counters[thread];
+    counter.value.store(counter.value.load(std::memory_order_relaxed) + pixels, std::memory_order_relaxed);
+
+    std::int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+    std::int64_t next = m_nextReport.load(std::memory_order_relaxed);
+    if (now < next)
+        return;
+
+    // Claim this report slot; losers of the race skip it, as does anyone
+    // arriving while a slow callback is still running.
+    if (!m_nextReport.compare_exchange_strong(next, now + m_interval.count(), std::memory_order_relaxed))
+        return;
+    if (m_reporting.exchange(true, std::memory_order_acquire))
+        return;
+
+    if (m_callback)
+        m_callback(snapshot());
+    m_reporting.store(false, std::memory_order_release);
+}
+
+void ProgressReporter::finish()
+{
+    if (m_callback)
+        m_callback(snapshot(true));
+}
+
+ProgressEvent ProgressReporter::snapshot(bool finished) const
+{
+    std::size_t done = 0;
+    for (int i = 0; i < m_threads; ++i)
+        done += m_counters[i].value.load(std::memory_order_relaxed);
+
+    double seconds = elapsed();
+    double remaining = 0;
+    if (!finished && done > 0 && done < m_total)
+        remaining = seconds * (m_total - done) / done;
+
+    return ProgressEvent{done, m_total, seconds, remaining, finished};
+}
+
+double ProgressReporter::elapsed() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+}
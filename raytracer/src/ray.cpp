@@ -1,5 +1,5 @@
 #include "ray.hpp"
-#include "matrix.hpp"
+#include "matrix4.hpp"
 
 using namespace raytracer;
 
@@ -23,7 +23,7 @@ Tuple Ray::position(double t) const
     return m_origin + t * m_direction;
 }
 
-Ray Ray::transform(const Matrix &m) const
+Ray Ray::transform(const Matrix4 &m) const
 {
     return Ray(m * m_origin, m * m_direction);
 }
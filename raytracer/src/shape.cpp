@@ -2,10 +2,15 @@
 #include "intersections.hpp"
 #include "ray.hpp"
 
+#include <cassert>
+
 using namespace raytracer;
 
+std::atomic<std::uint64_t> AShape::s_transformEpoch = 1;
+
 AShape::AShape()
-    : parent(nullptr), m_transform(Matrix::identity(4)), m_material(Material())
+    : parent(nullptr), m_transform(Matrix4::identity()), m_inverse(Matrix4::identity()), m_inverseTranspose(Matrix4::identity()), m_material(Material()),
+      m_worldInverse(Matrix4::identity()), m_worldInverseTranspose(Matrix4::identity()), m_commitEpoch(0), m_passThrough(false)
 {
 }
 
@@ -13,19 +18,33 @@ AShape::~AShape()
 {
 }
 
-const Matrix &AShape::transform() const
+const Matrix4 &AShape::transform() const
 {
     return m_transform;
 }
 
+const Matrix4 &AShape::inverseTransform() const
+{
+    return m_inverse;
+}
+
+const Matrix4 &AShape::transposedInverseTransform() const
+{
+    return m_inverseTranspose;
+}
+
 const Material &AShape::material() const
 {
     return m_material;
 }
 
-Matrix &AShape::transform()
+void AShape::setTransform(const Matrix4 &transform)
 {
-    return m_transform;
+    assert(transform.isInvertible());
+    m_transform = transform;
+    m_inverse = transform.inverse();
+    m_inverseTranspose = m_inverse.transpose();
+    invalidateTransforms();
 }
 
 Material &AShape::material()
@@ -33,16 +52,68 @@ Material &AShape::material()
     return m_material;
 }
 
-// Intersections AShape::intersect(const Ray &ray) const
-// {
-//     Ray object_ray = ray.transform(m_transform.inverse());
-//     return localIntersect(object_ray);
-// }
+Bounds AShape::parentSpaceBounds() const
+{
+    return bounds().transform(m_transform);
+}
+
+void AShape::commit(const Matrix4 &parentInverse)
+{
+    // Same product as worldToObject() walking up the parents, taken once.
+    m_worldInverse = m_inverse * parentInverse;
+    m_worldInverseTranspose = m_worldInverse.transpose();
+    m_commitEpoch = transformEpoch();
+}
+
+bool AShape::committed() const
+{
+    return m_commitEpoch == transformEpoch();
+}
+
+Ray AShape::localRay(const Ray &ray) const
+{
+    if (!committed())
+        return ray.transform(m_inverse);
+    return m_passThrough ? ray : ray.transform(m_worldInverse);
+}
 
 Intersections AShape::intersect(const Ray &ray) const
 {
-    Ray localRay = ray.transform(m_transform.inverse());
-    return localIntersect(localRay);
+    return localIntersect(localRay(ray));
+}
+
+bool AShape::occluded(const Ray &ray, double tmax) const
+{
+    // The transformed ray keeps the world ray's parametrisation, so tmax
+    // needs no conversion.
+    return localOccluded(localRay(ray), tmax);
+}
+
+bool AShape::localOccluded(const Ray &ray, double tmax) const
+{
+    Intersections xs = localIntersect(ray);
+    for (std::size_t i = 0; i < xs.count(); ++i)
+        if (xs[i].t() >= 0 && xs[i].t() < tmax)
+            return true;
+    return false;
+}
+
+std::optional<Intersection> AShape::closestHit(const Ray &ray, double tmin, double tmax) const
+{
+    return localClosestHit(localRay(ray), tmin, tmax);
+}
+
+std::optional<Intersection> AShape::localClosestHit(const Ray &ray, double tmin, double tmax) const
+{
+    Intersections xs = localIntersect(ray);
+    std::optional<Intersection> hit;
+    for (std::size_t i = 0; i < xs.count(); ++i) {
+        if (xs[i].t() >= tmin && xs[i].t() < tmax) {
+            hit = xs[i];
+            tmax = xs[i].t();
+        }
+    }
+    return hit;
 }
 
 Tuple AShape::normalAt(const Tuple &world_point) const
@@ -53,18 +124,39 @@ Tuple AShape::normalAt(const Tuple &world_point) const
     return world_normal;
 }
 
+Tuple AShape::normalAt(const Tuple &world_point, const Intersection &hit) const
+{
+    Point local_point = worldToObject(world_point.asPoint());
+    Vector local_normal = localNormalAt(local_point, hit);
+    return normalToWorld(local_normal);
+}
+
+Vector AShape::localNormalAt(const Point &local_point, const Intersection &) const
+{
+    return localNormalAt(local_point);
+}
+
 Point AShape::worldToObject(const Point &world_point) const
 {
+    if (committed())
+        return (m_worldInverse * world_point).asPoint();
+
     Point point = world_point;
     if (parent != nullptr)
         point = parent->worldToObject(point);
 
-    return (m_transform.inverse() * point).asPoint();
+    return (m_inverse * point).asPoint();
 }
 
 Vector AShape::normalToWorld(const Vector &local_normal) const
 {
-    Tuple normal = (m_transform.inverse().transpose() * local_normal);
+    if (committed()) {
+        Tuple normal = m_worldInverseTranspose * local_normal;
+        normal.w = 0;
+        return normal.normalize().asVector();
+    }
+
+    Tuple normal = (m_inverseTranspose * local_normal);
     normal.w = 0;
     normal = normal.normalize().asVector();
 
@@ -73,3 +165,41 @@ Vector AShape::normalToWorld(const Vector &local_normal) const
 
     return normal.asVector();
 }
+
+Matrix4 AShape::worldToObjectTransform() const
+{
+    if (committed())
+        return m_worldInverse;
+    if (parent != nullptr)
+        return m_inverse * parent->worldToObjectTransform();
+    return m_inverse;
+}
+
+Point AShape::worldToPattern(const Point &world_point, const APattern &pattern) const
+{
+    std::uint64_t epoch = transformEpoch();
+    if (m_patternCache.epoch.load(std::memory_order_acquire) != epoch) {
+        std::lock_guard<std::mutex> lock(m_patternCache.mutex);
+        if (m_patternCache.epoch.load(std::memory_order_relaxed) != epoch) {
+            m_patternCache.matrix = pattern.inverseTransform() * worldToObjectTransform();
+            m_patternCache.generation = pattern.generation();
+            m_patternCache.epoch.store(epoch, std::memory_order_release);
+        }
+    }
+
+    if (m_patternCache.generation == pattern.generation())
+        return (m_patternCache.matrix * world_point).asPoint();
+    // Some other pattern owns the cache for this epoch; evicting it would
+    // rewrite the matrix under the readers' feet.
+    return (pattern.inverseTransform() * worldToObject(world_point)).asPoint();
+}
+
+std::uint64_t AShape::transformEpoch()
+{
+    return s_transformEpoch.load(std::memory_order_acquire);
+}
+
+void AShape::invalidateTransforms()
+{
+    s_transformEpoch.fetch_add(1, std::memory_order_acq_rel);
+}
@@ -43,7 +43,7 @@ Bounds Sphere::bounds() const
 
 GlassSphere::GlassSphere() : Sphere()
 {
-    m_transform = Matrix::identity(4);
+    setTransform(Matrix4::identity());
     m_material.transparency = 1.0;
     m_material.refractiveIndex = 1.5;
 }
@@ -0,0 +1,112 @@
+#include "tile_scheduler.hpp"
+
+#include <stdexcept>
+
+using namespace raytracer;
+
+// Position of the d-th cell along a Hilbert curve filling an n x n grid, n a
+// power of two.
+static void hilbertCell(int n, int d, int &x, int &y)
+{
+    x = y = 0;
+    for (int s = 1; s < n; s *= 2) {
+        int rx = 1 & (d / 2);
+        int ry = 1 & (d ^ rx);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            std::swap(x, y);
+        }
+        x += s * rx;
+        y += s * ry;
+        d /= 4;
+    }
+}
+
+// Grid cells of a columns x rows grid in the requested order.
+static std::vector<std::pair<int, int>> orderCells(int columns, int rows, TileOrder order)
+{
+    std::vector<std::pair<int, int>> cells;
+    cells.reserve(static_cast<std::size_t>(columns) * rows);
+    auto inside = [&](int x, int y) { return x >= 0 && x < columns && y >= 0 && y < rows; };
+
+    switch (order) {
+    case TileOrder::Scanline:
+        for (int y = 0; y < rows; ++y)
+            for (int x = 0; x < columns; ++x)
+                cells.emplace_back(x, y);
+        break;
+
+    case TileOrder::Hilbert: {
+        // Walk the curve over the smallest power-of-two square covering the
+        // grid and keep the cells that fall inside it.
+        int n = 1;
+        while (n < columns || n < rows)
+            n *= 2;
+        for (int d = 0; d < n * n; ++d) {
+            int x, y;
+            hilbertCell(n, d, x, y);
+            if (inside(x, y))
+                cells.emplace_back(x, y);
+        }
+        break;
+    }
+
+    case TileOrder::Spiral: {
+        // Square spiral from the center: 1 right, 1 down, 2 left, 2 up, 3
+        // right... skipping cells outside the grid until all are visited.
+        static const int dx[] = {1, 0, -1, 0};
+        static const int dy[] = {0, 1, 0, -1};
+        int x = (columns - 1) / 2;
+        int y = (rows - 1) / 2;
+        std::size_t total = static_cast<std::size_t>(columns) * rows;
+        cells.emplace_back(x, y);
+        for (int leg = 0; cells.size() < total; ++leg) {
+            int length = leg / 2 + 1;
+            for (int step = 0; step < length; ++step) {
+                x += dx[leg % 4];
+                y += dy[leg % 4];
+                if (inside(x, y))
+                    cells.emplace_back(x, y);
+            }
+        }
+        break;
+    }
+    }
+
+    return cells;
+}
+
+TileScheduler::TileScheduler(int width, int height, int tileSize, TileOrder order)
+    : m_tiles(), m_next(0)
+{
+    if (tileSize <= 0)
+        throw std::invalid_argument("TileScheduler: tile size must be positive.");
+
+    if (width <= 0 || height <= 0)
+        return;
+
+    int columns = (width + tileSize - 1) / tileSize;
+    int rows = (height + tileSize - 1) / tileSize;
+    for (auto [column, row] : orderCells(columns, rows, order)) {
+        int x0 = column * tileSize;
+        int y0 = row * tileSize;
+        m_tiles.push_back({x0, y0, std::min(x0 + tileSize, width), std::min(y0 + tileSize, height)});
+    }
+}
+
+bool TileScheduler::next(Tile &tile)
+{
+    std::size_t index = m_next.fetch_add(1, std::memory_order_relaxed);
+    if (index >= m_tiles.size())
+        return false;
+    tile = m_tiles[index];
+    return true;
+}
+
+void TileScheduler::reset()
+{
+    m_next.store(0, std::memory_order_relaxed);
+}
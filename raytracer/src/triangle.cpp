@@ -8,6 +8,22 @@ Triangle::Triangle(const Point &p1, const Point &p2, const Point &p3)
 }
 
 Intersections Triangle::localIntersect(const Ray &ray) const
+{
+    double t, u, v;
+    if (!hitDistance(ray, t, u, v))
+        return Intersections();
+    return Intersections({Intersection(t, *this, u, v)});
+}
+
+std::optional<Intersection> Triangle::localClosestHit(const Ray &ray, double tmin, double tmax) const
+{
+    double t, u, v;
+    if (!hitDistance(ray, t, u, v) || t < tmin || t >= tmax)
+        return std::nullopt;
+    return Intersection(t, *this, u, v);
+}
+
+bool Triangle::hitDistance(const Ray &ray, double &t, double &u, double &v) const
 {
     auto d = ray.direction();
     auto o = ray.origin();
@@ -15,21 +31,21 @@ Intersections Triangle::localIntersect(const Ray &ray) const
     auto dir_cross_e2 = d.cross(e2);
     auto det = e1.dot(dir_cross_e2);
     if (std::abs(det) < EPSILON) {
-        return Intersections();
+        return false;
     }
     auto f = 1 / det;
     auto p1_to_origin = o - p1;
-    auto u = f * p1_to_origin.dot(dir_cross_e2);
+    u = f * p1_to_origin.dot(dir_cross_e2);
     if (u < 0 || u > 1) {
-        return Intersections();
+        return false;
     }
     auto origin_cross_e1 = p1_to_origin.cross(e1);
-    auto v = f * d.dot(origin_cross_e1);
+    v = f * d.dot(origin_cross_e1);
     if (v < 0 || (u + v) > 1) {
-        return Intersections();
+        return false;
     }
-    auto t = f * e2.dot(origin_cross_e1);
-    return Intersections({Intersection(t, *this)});
+    t = f * e2.dot(origin_cross_e1);
+    return true;
 }
 
 Vector Triangle::localNormalAt(const Point &) const
@@ -41,3 +57,13 @@ Bounds Triangle::bounds() const
 {
     return Bounds(p1).add(p2).add(p3);
 }
+
+SmoothTriangle::SmoothTriangle(const Point &p1, const Point &p2, const Point &p3, const Vector &n1, const Vector &n2, const Vector &n3)
+    : Triangle(p1, p2, p3), n1(n1), n2(n2), n3(n3)
+{
+}
+
+Vector SmoothTriangle::localNormalAt(const Point &, const Intersection &hit) const
+{
+    return (n2 * hit.u() + n3 * hit.v() + n1 * (1 - hit.u() - hit.v())).asVector();
+}
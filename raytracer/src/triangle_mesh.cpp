@@ -0,0 +1,161 @@
+#include "triangle_mesh.hpp"
+
+using namespace raytracer;
+
+TriangleMesh::TriangleMesh(MeshData mesh, int maxLeafSize)
+    : AShape(), m_geometry()
+{
+    auto geometry = std::make_shared<Geometry>();
+    geometry->mesh = std::move(mesh);
+
+    std::vector<Bounds> bounds;
+    bounds.reserve(geometry->mesh.triangleCount());
+    for (std::uint32_t i = 0; i < geometry->mesh.triangleCount(); ++i) {
+        auto corner = [&](int c) {
+            const double *p = &geometry->mesh.positions[3 * geometry->mesh.positionIndices[3 * i + c]];
+            return Point(p[0], p[1], p[2]);
+        };
+        bounds.push_back(Bounds(corner(0)).add(corner(1)).add(corner(2)));
+    }
+    geometry->tree.build(bounds, maxLeafSize);
+
+    m_geometry = std::move(geometry);
+}
+
+TriangleMesh::TriangleMesh(MeshData mesh, LinearBVH tree)
+    : AShape(), m_geometry(std::make_shared<const Geometry>(Geometry{std::move(mesh), std::move(tree)}))
+{
+}
+
+Intersections TriangleMesh::localIntersect(const Ray &ray) const
+{
+    Intersections result;
+    double closest = std::numeric_limits<double>::infinity();
+    m_geometry->tree.traverse(ray, closest, [&](std::uint32_t i, double &nearest) {
+        double t, u, v;
+        if (!hitDistance(ray, i, t, u, v))
+            return;
+        if (t >= 0 && t < nearest)
+            nearest = t;
+        result.add(Intersection(t, *this, u, v, i));
+    });
+    return result;
+}
+
+bool TriangleMesh::localOccluded(const Ray &ray, double tmax) const
+{
+    return m_geometry->tree.any(ray, tmax, [&](std::uint32_t i) {
+        double t, u, v;
+        return hitDistance(ray, i, t, u, v) && t >= 0 && t < tmax;
+    });
+}
+
+std::optional<Intersection> TriangleMesh::localClosestHit(const Ray &ray, double tmin, double tmax) const
+{
+    std::optional<Intersection> hit;
+    m_geometry->tree.traverse(ray, tmin, tmax, [&](std::uint32_t i, double &nearest) {
+        double t, u, v;
+        if (hitDistance(ray, i, t, u, v) && t >= tmin && t < nearest) {
+            hit = Intersection(t, *this, u, v, i);
+            nearest = t;
+        }
+    });
+    return hit;
+}
+
+bool TriangleMesh::hitDistance(const Ray &ray, std::uint32_t i, double &t, double &u, double &v) const
+{
+    // Moller-Trumbore as in Triangle::hitDistance, on plain doubles read
+    // straight from the shared vertex buffer.
+    const MeshData &mesh = m_geometry->mesh;
+    const double *p1 = &mesh.positions[3 * mesh.positionIndices[3 * i]];
+    const double *p2 = &mesh.positions[3 * mesh.positionIndices[3 * i + 1]];
+    const double *p3 = &mesh.positions[3 * mesh.positionIndices[3 * i + 2]];
+    const double e1[3] = {p2[0] - p1[0], p2[1] - p1[1], p2[2] - p1[2]};
+    const double e2[3] = {p3[0] - p1[0], p3[1] - p1[1], p3[2] - p1[2]};
+
+    Tuple o = ray.origin();
+    Tuple d = ray.direction();
+
+    const double dir_cross_e2[3] = {d.y * e2[2] - d.z * e2[1], d.z * e2[0] - d.x * e2[2], d.x * e2[1] - d.y * e2[0]};
+    double det = e1[0] * dir_cross_e2[0] + e1[1] * dir_cross_e2[1] + e1[2] * dir_cross_e2[2];
+    if (std::abs(det) < EPSILON)
+        return false;
+    double f = 1 / det;
+    const double p1_to_origin[3] = {o.x - p1[0], o.y - p1[1], o.z - p1[2]};
+    u = f * (p1_to_origin[0] * dir_cross_e2[0] + p1_to_origin[1] * dir_cross_e2[1] + p1_to_origin[2] * dir_cross_e2[2]);
+    if (u < 0 || u > 1)
+        return false;
+    const double origin_cross_e1[3] = {
+        p1_to_origin[1] * e1[2] - p1_to_origin[2] * e1[1],
+        p1_to_origin[2] * e1[0] - p1_to_origin[0] * e1[2],
+        p1_to_origin[0] * e1[1] - p1_to_origin[1] * e1[0],
+    };
+    v = f * (d.x * origin_cross_e1[0] + d.y * origin_cross_e1[1] + d.z * origin_cross_e1[2]);
+    if (v < 0 || (u + v) > 1)
+        return false;
+    t = f * (e2[0] * origin_cross_e1[0] + e2[1] * origin_cross_e1[1] + e2[2] * origin_cross_e1[2]);
+    return true;
+}
+
+Vector TriangleMesh::localNormalAt(const Point &) const
+{
+    throw std::runtime_error("TriangleMesh::localNormalAt needs the intersection.");
+}
+
+Vector TriangleMesh::localNormalAt(const Point &, const Intersection &hit) const
+{
+    // Triangles with a normal on every corner are smooth: blend the corner
+    // normals with the barycentric coordinates of the hit, as
+    // SmoothTriangle does. The others are flat.
+    const MeshData &mesh = m_geometry->mesh;
+    std::uint32_t triangle = hit.primitive();
+    if (mesh.normalIndices.empty())
+        return faceNormal(triangle);
+
+    const std::uint32_t *corners = &mesh.normalIndices[3 * triangle];
+    if (corners[0] == MeshData::None || corners[1] == MeshData::None || corners[2] == MeshData::None)
+        return faceNormal(triangle);
+
+    double w[3] = {1 - hit.u() - hit.v(), hit.u(), hit.v()};
+    double n[3] = {0, 0, 0};
+    for (int c = 0; c < 3; ++c)
+        for (int k = 0; k < 3; ++k)
+            n[k] += w[c] * mesh.normals[3 * corners[c] + k];
+    return Vector(n[0], n[1], n[2]);
+}
+
+Bounds TriangleMesh::bounds() const
+{
+    return m_geometry->tree.bounds();
+}
+
+std::size_t TriangleMesh::size() const
+{
+    return m_geometry->mesh.triangleCount();
+}
+
+const MeshData &TriangleMesh::mesh() const
+{
+    return m_geometry->mesh;
+}
+
+const LinearBVH &TriangleMesh::tree() const
+{
+    return m_geometry->tree;
+}
+
+Point TriangleMesh::vertex(std::uint32_t triangle, int corner) const
+{
+    const MeshData &mesh = m_geometry->mesh;
+    const double *p = &mesh.positions[3 * mesh.positionIndices[3 * triangle + corner]];
+    return Point(p[0], p[1], p[2]);
+}
+
+Vector TriangleMesh::faceNormal(std::uint32_t triangle) const
+{
+    Point p1 = vertex(triangle, 0);
+    Vector e1 = (vertex(triangle, 1) - p1).asVector();
+    Vector e2 = (vertex(triangle, 2) - p1).asVector();
+    return e2.cross(e1).normalize().asVector();
+}
@@ -20,7 +20,7 @@ World *World::Default()
     world->shapes().push_back(s1);
 
     Sphere *s2 = new Sphere();
-    s2->transform() = Matrix::scaling(0.5, 0.5, 0.5);
+    s2->setTransform(Matrix4::scaling(0.5, 0.5, 0.5));
     world->shapes().push_back(s2);
 
     return world;
@@ -40,15 +40,32 @@ World::~World()
         delete m_light;
 }
 
+void World::commit()
+{
+    for (auto shape : m_shapes)
+        shape->commit(Matrix4::identity());
+}
+
 Intersections World::intersect(const Ray &ray) const
 {
     Intersections xs;
     for (auto shape : m_shapes)
-        xs.add(shape->intersect(ray));
-    xs.sort();
+        xs.merge(shape->intersect(ray));
     return xs;
 }
 
+std::optional<Intersection> World::closestHit(const Ray &ray, double tmin, double tmax) const
+{
+    std::optional<Intersection> hit;
+    for (auto shape : m_shapes) {
+        if (auto h = shape->closestHit(ray, tmin, tmax)) {
+            hit = h;
+            tmax = h->t();
+        }
+    }
+    return hit;
+}
+
 Color World::shadeHit(const Computations &comps, int remaining) const
 {
     bool shadowed = isShadowed(comps.overPoint);
@@ -66,13 +83,21 @@ Color World::shadeHit(const Computations &comps, int remaining) const
 
 Color World::colorAt(const Ray &ray, int remaining) const
 {
-    auto xs = intersect(ray);
-    auto hit = xs.hit();
-    if (hit != nullptr) {
-        auto comps = hit->prepareComputations(ray, xs);
+    auto hit = closestHit(ray, 0, std::numeric_limits<double>::infinity());
+    if (!hit)
+        return Color(0, 0, 0);
+
+    // Refraction needs every intersection along the ray to know which
+    // objects the hit lies inside; opaque hits never read n1/n2, so scenes
+    // without transparent materials never build the list or track containers.
+    if (hit->shape().material().transparency > 0) {
+        auto xs = intersect(ray);
+        auto comps = xs.hit()->prepareComputations(ray, xs);
         return shadeHit(comps, remaining);
     }
-    return Color(0, 0, 0);
+
+    auto comps = hit->prepareComputations(ray);
+    return shadeHit(comps, remaining);
 }
 
 bool World::isShadowed(const Point &point) const
@@ -82,10 +107,9 @@ bool World::isShadowed(const Point &point) const
     Vector direction = v.normalize().asVector();
 
     Ray r(point, direction);
-    auto xs = intersect(r);
-    auto h = xs.hit();
-    if (h != nullptr && h->t() < distance)
-        return true;
+    for (auto shape : m_shapes)
+        if (shape->occluded(r, distance))
+            return true;
     return false;
 }
 
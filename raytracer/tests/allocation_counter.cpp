@@ -0,0 +1,49 @@
+#include "allocation_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<std::size_t> allocations{0};
+
+static void *allocate(std::size_t size, std::size_t alignment)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (size == 0)
+        size = 1;
+
+    void *p = nullptr;
+    if (alignment <= alignof(std::max_align_t))
+        p = std::malloc(size);
+    else
+        p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new(std::size_t size) { return allocate(size, 0); }
+void *operator new[](std::size_t size) { return allocate(size, 0); }
+void *operator new(std::size_t size, std::align_val_t alignment) { return allocate(size, static_cast<std::size_t>(alignment)); }
+void *operator new[](std::size_t size, std::align_val_t alignment) { return allocate(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+AllocationCounter::AllocationCounter()
+    : m_start(allocations.load(std::memory_order_relaxed))
+{
+}
+
+std::size_t AllocationCounter::count() const
+{
+    return allocations.load(std::memory_order_relaxed) - m_start;
+}
@@ -0,0 +1,18 @@
+#ifndef __ALLOCATION_COUNTER_HPP__
+#define __ALLOCATION_COUNTER_HPP__
+
+#include <cstddef>
+
+// Counts the calls to the global operator new made since construction. The
+// test binary replaces operator new in allocation_counter.cpp to feed it.
+class AllocationCounter {
+public:
+    AllocationCounter();
+
+    std::size_t count() const;
+
+private:
+    std::size_t m_start;
+};
+
+#endif // __ALLOCATION_COUNTER_HPP__
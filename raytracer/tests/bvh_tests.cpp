@@ -0,0 +1,172 @@
+#include "raytracer.hpp"
+
+#include <gmock/gmock.h>
+
+class BVHTest : public ::testing::Test {};
+
+static std::vector<raytracer::Shape *> sphereGrid(int n)
+{
+    std::vector<raytracer::Shape *> shapes;
+    for (int x = 0; x < n; ++x) {
+        for (int y = 0; y < n; ++y) {
+            raytracer::Sphere *s = new raytracer::Sphere();
+            s->setTransform(raytracer::Matrix4::translation(x * 3, y * 3, 0));
+            shapes.push_back(s);
+        }
+    }
+    return shapes;
+}
+
+// An empty BVH has no intersections
+TEST_F(BVHTest, An_empty_BVH_has_no_intersections)
+{
+    raytracer::BVH bvh({});
+    raytracer::Ray r(raytracer::Point(0, 0, -5), raytracer::Vector(0, 0, 1));
+    ASSERT_EQ(bvh.size(), 0);
+    ASSERT_EQ(bvh.intersect(r).count(), 0);
+}
+
+// The bounds of a BVH contain every shape
+TEST_F(BVHTest, The_bounds_of_a_BVH_contain_every_shape)
+{
+    raytracer::BVH bvh({new raytracer::Triangle(raytracer::Point(-1, 0, 0), raytracer::Point(0, 2, 0), raytracer::Point(1, 0, 0)),
+                        new raytracer::Triangle(raytracer::Point(4, 0, 3), raytracer::Point(5, -1, 0), raytracer::Point(6, 0, 0))});
+    auto b = bvh.bounds();
+    ASSERT_TRUE(b.min == raytracer::Point(-1, -1, 0));
+    ASSERT_TRUE(b.max == raytracer::Point(6, 2, 3));
+}
+
+// A ray hits the shape it is aimed at
+TEST_F(BVHTest, A_ray_hits_the_shape_it_is_aimed_at)
+{
+    std::vector<raytracer::Shape *> shapes;
+    for (int i = 0; i < 64; ++i)
+        shapes.push_back(new raytracer::Triangle(raytracer::Point(i * 3 - 1, 0, i), raytracer::Point(i * 3, 1, i), raytracer::Point(i * 3 + 1, 0, i)));
+    raytracer::Shape *target = shapes[37];
+    raytracer::BVH bvh(shapes, 2);
+
+    raytracer::Ray r(raytracer::Point(37 * 3, 0.25, -5), raytracer::Vector(0, 0, 1));
+    auto xs = bvh.intersect(r);
+    auto hit = xs.hit();
+    ASSERT_TRUE(hit != nullptr);
+    ASSERT_EQ(&hit->shape(), target);
+    ASSERT_TRUE(double_equals(hit->t(), 42));
+}
+
+// A BVH finds the same hits as a group
+TEST_F(BVHTest, A_BVH_finds_the_same_hits_as_a_group)
+{
+    raytracer::Group group;
+    for (auto shape : sphereGrid(6))
+        group.add(shape);
+    raytracer::BVH bvh(sphereGrid(6), 1);
+
+    for (int x = -2; x < 20; ++x) {
+        for (int y = -2; y < 20; ++y) {
+            raytracer::Ray r(raytracer::Point(x * 0.9, y * 0.9, -10), raytracer::Vector(0.01 * x, -0.01 * y, 1).normalize());
+            auto expectedXs = group.intersect(r);
+            auto actualXs = bvh.intersect(r);
+            auto expected = expectedXs.hit();
+            auto actual = actualXs.hit();
+            ASSERT_EQ(expected == nullptr, actual == nullptr);
+            if (expected) {
+                ASSERT_TRUE(double_equals(expected->t(), actual->t()));
+            }
+        }
+    }
+}
+
+// A BVH stores its nodes depth first with every primitive in exactly one leaf
+TEST_F(BVHTest, A_BVH_stores_its_nodes_depth_first_with_every_primitive_in_one_leaf)
+{
+    raytracer::BVH bvh(sphereGrid(8), 2);
+    const auto &nodes = bvh.tree().nodes();
+    const auto &indices = bvh.tree().indices();
+    ASSERT_EQ(indices.size(), 64);
+
+    std::vector<int> seen(indices.size(), 0);
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        const auto &node = nodes[i];
+        if (node.count > 0) {
+            ASSERT_LE(node.offset + node.count, indices.size());
+            for (std::uint32_t j = node.offset; j < node.offset + node.count; ++j)
+                seen[indices[j]]++;
+            continue;
+        }
+        // The left child follows its parent, the right child comes after the
+        // whole left subtree, and both fit inside the parent box.
+        ASSERT_GT(node.offset, i + 1);
+        ASSERT_LT(node.offset, nodes.size());
+        for (auto child : {i + 1, static_cast<std::size_t>(node.offset)}) {
+            for (int axis = 0; axis < 3; ++axis) {
+                ASSERT_LE(node.min[axis], nodes[child].min[axis]);
+                ASSERT_GE(node.max[axis], nodes[child].max[axis]);
+            }
+        }
+    }
+    for (auto count : seen)
+        ASSERT_EQ(count, 1);
+}
+
+// A BVH reports the same occlusion as a group
+TEST_F(BVHTest, A_BVH_reports_the_same_occlusion_as_a_group)
+{
+    raytracer::Group group;
+    for (auto shape : sphereGrid(6))
+        group.add(shape);
+    raytracer::BVH bvh(sphereGrid(6), 1);
+
+    for (int x = -2; x < 20; ++x) {
+        for (int y = -2; y < 20; ++y) {
+            raytracer::Ray r(raytracer::Point(x * 0.9, y * 0.9, -10), raytracer::Vector(0.01 * x, -0.01 * y, 1).normalize());
+            for (double tmax : {5.0, 9.5, 10.0, 100.0})
+                ASSERT_EQ(group.occluded(r, tmax), bvh.occluded(r, tmax));
+        }
+    }
+}
+
+// A BVH finds the same closest hit as a group
+TEST_F(BVHTest, A_BVH_finds_the_same_closest_hit_as_a_group)
+{
+    raytracer::Group group;
+    for (auto shape : sphereGrid(6))
+        group.add(shape);
+    raytracer::BVH bvh(sphereGrid(6), 1);
+
+    for (int x = -2; x < 20; ++x) {
+        for (int y = -2; y < 20; ++y) {
+            raytracer::Ray r(raytracer::Point(x * 0.9, y * 0.9, -10), raytracer::Vector(0.01 * x, -0.01 * y, 1).normalize());
+            auto xs = group.intersect(r);
+            auto expected = xs.hit();
+            auto actual = bvh.closestHit(r, 0, std::numeric_limits<double>::infinity());
+            ASSERT_EQ(expected == nullptr, !actual.has_value());
+            if (expected) {
+                ASSERT_TRUE(double_equals(expected->t(), actual->t()));
+            }
+        }
+    }
+}
+
+// The normal on a shape in a transformed BVH goes through the BVH's transform
+TEST_F(BVHTest, The_normal_on_a_shape_in_a_transformed_BVH_goes_through_the_BVHs_transform)
+{
+    raytracer::Sphere *sphere = new raytracer::Sphere();
+    raytracer::BVH bvh({sphere});
+    bvh.setTransform(raytracer::Matrix4::translation(3, 0, 5));
+    EXPECT_EQ(sphere->parent, &bvh);
+
+    raytracer::Ray r(raytracer::Point(3.5, 0, -5), raytracer::Vector(0, 0, 1));
+    for (int pass = 0; pass < 2; ++pass) {
+        auto hit = bvh.closestHit(r, 0, std::numeric_limits<double>::infinity());
+        ASSERT_TRUE(hit.has_value());
+        ASSERT_EQ(&hit->shape(), sphere);
+        EXPECT_TRUE(double_equals(hit->t(), 10 - std::sqrt(0.75)));
+        EXPECT_TRUE(sphere->normalAt(r.position(hit->t()), *hit) == raytracer::Vector(0.5, 0, -std::sqrt(0.75)));
+        EXPECT_EQ(bvh.intersect(r).count(), 2);
+        EXPECT_TRUE(bvh.occluded(r, 10));
+
+        // The second pass goes through the baked transforms of World::commit.
+        bvh.commit(raytracer::Matrix4::identity());
+        EXPECT_TRUE(sphere->committed());
+    }
+}
@@ -14,7 +14,7 @@ TEST_F(CameraTest, Constructing_a_camera)
     EXPECT_EQ(c.hsize, hsize);
     EXPECT_EQ(c.vsize, vsize);
     EXPECT_EQ(c.fieldOfView, fieldOfView);
-    EXPECT_TRUE(c.transform == raytracer::Matrix::identity(4));
+    EXPECT_TRUE(c.transform() == raytracer::Matrix4::identity());
 }
 
 // The pixel size for a horizontal canvas
@@ -53,7 +53,7 @@ TEST_F(CameraTest, Constructing_a_ray_through_a_corner_of_the_canvas)
 TEST_F(CameraTest, Constructing_a_ray_when_the_camera_is_transformed)
 {
     raytracer::Camera c(201, 101, M_PI / 2);
-    c.transform = raytracer::Matrix::rotationY(M_PI / 4) * raytracer::Matrix::translation(0, -2, 5);
+    c.setTransform(raytracer::Matrix4::rotationY(M_PI / 4) * raytracer::Matrix4::translation(0, -2, 5));
     raytracer::Ray r = c.rayForPixel(100, 50);
     EXPECT_TRUE(r.origin() == raytracer::Point(0, 2, -5));
     EXPECT_TRUE(r.direction() == raytracer::Vector(std::sqrt(2) / 2, 0, -std::sqrt(2) / 2));
@@ -67,8 +67,59 @@ TEST_F(CameraTest, Rendering_a_world_with_a_camera)
     raytracer::Point from(0, 0, -5);
     raytracer::Point to(0, 0, 0);
     raytracer::Vector up(0, 1, 0);
-    c.transform = raytracer::Matrix::viewTransform(from, to, up);
+    c.setTransform(raytracer::Matrix4::viewTransform(from, to, up));
     raytracer::Canvas image = c.render(*w);
     EXPECT_TRUE(image.pixelAt(5, 5) == raytracer::Color(0.38066, 0.47583, 0.2855));
     delete w;
 }
+
+// Rendering a world tile by tile matches the default render
+TEST_F(CameraTest, Rendering_a_world_tile_by_tile_matches_the_default_render)
+{
+    raytracer::World *w = raytracer::World::Default();
+    raytracer::Camera c(23, 17, M_PI / 2);
+    c.setTransform(raytracer::Matrix4::viewTransform(raytracer::Point(0, 0, -5), raytracer::Point(0, 0, 0), raytracer::Vector(0, 1, 0)));
+    raytracer::Canvas expected = c.render(*w);
+    for (auto order : {raytracer::TileOrder::Scanline, raytracer::TileOrder::Hilbert, raytracer::TileOrder::Spiral}) {
+        raytracer::RenderOptions options;
+        // RGBA32F rows align on 4 pixels, so 4-pixel tiles stay 4 pixels wide.
+        options.format = raytracer::PixelFormat::RGBA32F;
+        options.tileSize = 4;
+        options.order = order;
+        options.threads = 3;
+        raytracer::Canvas image = c.render(*w, options);
+        for (int y = 0; y < c.vsize; ++y)
+            for (int x = 0; x < c.hsize; ++x)
+                ASSERT_TRUE(image.pixelAt(x, y) == expected.pixelAt(x, y));
+    }
+    delete w;
+}
+
+// Setting the transform caches its inverse and the eye position
+TEST_F(CameraTest, Setting_the_transform_caches_its_inverse_and_the_eye_position)
+{
+    raytracer::Camera c(201, 101, M_PI / 2);
+    auto t = raytracer::Matrix4::rotationY(M_PI / 4) * raytracer::Matrix4::translation(0, -2, 5);
+    c.setTransform(t);
+    EXPECT_TRUE(c.inverseTransform() == t.inverse());
+    EXPECT_TRUE(c.origin() == raytracer::Point(0, 2, -5));
+}
+
+// Generating the rays of a tile matches rayForPixel
+TEST_F(CameraTest, Generating_the_rays_of_a_tile_matches_rayForPixel)
+{
+    raytracer::Camera c(201, 101, M_PI / 2);
+    c.setTransform(raytracer::Matrix4::rotationY(M_PI / 4) * raytracer::Matrix4::translation(0, -2, 5));
+    raytracer::Tile tile{96, 40, 107, 48};
+    std::vector<double> dx(tile.pixels()), dy(tile.pixels()), dz(tile.pixels());
+    c.generateRays(tile, dx, dy, dz);
+
+    std::size_t i = 0;
+    for (int y = tile.y0; y < tile.y1; ++y) {
+        for (int x = tile.x0; x < tile.x1; ++x, ++i) {
+            raytracer::Ray r = c.rayForPixel(x, y);
+            ASSERT_TRUE(r.origin() == c.origin());
+            ASSERT_TRUE(r.direction() == raytracer::Vector(dx[i], dy[i], dz[i]));
+        }
+    }
+}
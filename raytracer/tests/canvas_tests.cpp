@@ -1,3 +1,4 @@
+#include "allocation_counter.hpp"
 #include "raytracer.hpp"
 
 #include <gmock/gmock.h>
@@ -96,3 +97,70 @@ TEST_F(CanvasTest, PPM_files_are_terminated_by_a_newline_character)
     std::string ppm = c.toPPM();
     EXPECT_EQ(ppm[ppm.length() - 1], '\n');
 }
+
+// Every pixel format stores a color
+TEST_F(CanvasTest, Every_pixel_format_stores_a_color)
+{
+    for (auto format : {raytracer::PixelFormat::RGB32F, raytracer::PixelFormat::RGBA32F, raytracer::PixelFormat::RGB64F}) {
+        raytracer::Canvas c(7, 5, format);
+        EXPECT_EQ(c.format(), format);
+        c.writePixel(6, 4, raytracer::Color(0.25, 0.5, 1.5));
+        EXPECT_EQ(c.pixelAt(6, 4), raytracer::Color(0.25, 0.5, 1.5));
+        EXPECT_EQ(c.pixelAt(5, 4), raytracer::Color(0, 0, 0));
+    }
+}
+
+// A canvas is a single allocation whatever its size
+TEST_F(CanvasTest, A_canvas_is_a_single_allocation_whatever_its_size)
+{
+    AllocationCounter allocations;
+    raytracer::Canvas c(640, 480);
+    EXPECT_EQ(allocations.count(), 1);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(c.data(0)) % raytracer::Canvas::CacheLine, 0);
+}
+
+// Rows are padded to whole cache lines
+TEST_F(CanvasTest, Rows_are_padded_to_whole_cache_lines)
+{
+    raytracer::Canvas c(10, 3, raytracer::PixelFormat::RGB32F);
+    EXPECT_EQ(c.stride(), 128);
+    EXPECT_EQ(c.data(2) - c.data(0), 256);
+    EXPECT_EQ(c.tileAlignment(), 16);
+    EXPECT_EQ(raytracer::Canvas(1, 1, raytracer::PixelFormat::RGBA32F).tileAlignment(), 4);
+    EXPECT_EQ(raytracer::Canvas(1, 1, raytracer::PixelFormat::RGB64F).tileAlignment(), 8);
+}
+
+// Writing through a tile view uses tile coordinates
+TEST_F(CanvasTest, Writing_through_a_tile_view_uses_tile_coordinates)
+{
+    raytracer::Canvas c(20, 10);
+    raytracer::CanvasView view = c.tile(raytracer::Tile{16, 4, 20, 8});
+    EXPECT_EQ(view.width(), 4);
+    EXPECT_EQ(view.height(), 4);
+    view.writePixel(1, 2, raytracer::Color(1, 0, 0));
+    EXPECT_EQ(c.pixelAt(17, 6), raytracer::Color(1, 0, 0));
+    EXPECT_EQ(view.pixelAt(1, 2), raytracer::Color(1, 0, 0));
+}
+
+// A row view covers one row of the canvas
+TEST_F(CanvasTest, A_row_view_covers_one_row_of_the_canvas)
+{
+    raytracer::Canvas c(6, 4, raytracer::PixelFormat::RGB64F);
+    raytracer::CanvasView row = c.row(3);
+    EXPECT_EQ(row.width(), 6);
+    EXPECT_EQ(row.height(), 1);
+    row.writePixel(5, 0, raytracer::Color(0, 0, 1));
+    EXPECT_EQ(c.pixelAt(5, 3), raytracer::Color(0, 0, 1));
+    EXPECT_EQ(row.data(0), c.data(3));
+}
+
+// Copying a canvas copies its pixels
+TEST_F(CanvasTest, Copying_a_canvas_copies_its_pixels)
+{
+    raytracer::Canvas c(3, 3, raytracer::PixelFormat::RGBA32F);
+    c.writePixel(1, 1, raytracer::Color(0, 1, 0));
+    raytracer::Canvas copy = c;
+    c.writePixel(1, 1, raytracer::Color(1, 1, 1));
+    EXPECT_EQ(copy.format(), raytracer::PixelFormat::RGBA32F);
+    EXPECT_EQ(copy.pixelAt(1, 1), raytracer::Color(0, 1, 0));
+}
@@ -4,11 +4,23 @@
 
 class GroupTest : public ::testing::Test {};
 
+// Sphere counting the rays that reach it.
+class CountingSphere : public raytracer::Sphere {
+public:
+    raytracer::Intersections localIntersect(const raytracer::Ray &ray) const override
+    {
+        ++calls;
+        return raytracer::Sphere::localIntersect(ray);
+    }
+
+    mutable int calls = 0;
+};
+
 // Creating a new group
 TEST_F(GroupTest, Creating_a_new_group)
 {
     raytracer::Group group;
-    ASSERT_TRUE(group.transform() == raytracer::Matrix::identity(4));
+    ASSERT_TRUE(group.transform() == raytracer::Matrix4::identity());
     ASSERT_TRUE(group.empty());
 }
 
@@ -38,8 +50,8 @@ TEST_F(GroupTest, Intersecting_a_ray_with_a_nonempty_group)
     raytracer::Sphere *s1 = new raytracer::Sphere();
     raytracer::Sphere *s2 = new raytracer::Sphere();
     raytracer::Sphere *s3 = new raytracer::Sphere();
-    s2->transform() = raytracer::Matrix::translation(0, 0, -3);
-    s3->transform() = raytracer::Matrix::translation(5, 0, 0);
+    s2->setTransform(raytracer::Matrix4::translation(0, 0, -3));
+    s3->setTransform(raytracer::Matrix4::translation(5, 0, 0));
     group.add(s1);
     group.add(s2);
     group.add(s3);
@@ -56,11 +68,152 @@ TEST_F(GroupTest, Intersecting_a_ray_with_a_nonempty_group)
 TEST_F(GroupTest, Intersecting_a_transformed_group)
 {
     raytracer::Group group;
-    group.transform() = raytracer::Matrix::scaling(2, 2, 2);
+    group.setTransform(raytracer::Matrix4::scaling(2, 2, 2));
     raytracer::Sphere *s = new raytracer::Sphere();
-    s->transform() = raytracer::Matrix::translation(5, 0, 0);
+    s->setTransform(raytracer::Matrix4::translation(5, 0, 0));
     group.add(s);
     raytracer::Ray ray(raytracer::Point(10, 0, -10), raytracer::Vector(0, 0, 1));
     auto intersections = group.intersect(ray);
     ASSERT_EQ(intersections.count(), 2);
 }
+
+// A transformed group occludes a ray only before the maximum distance
+TEST_F(GroupTest, A_transformed_group_occludes_a_ray_only_before_the_maximum_distance)
+{
+    raytracer::Group group;
+    group.setTransform(raytracer::Matrix4::scaling(2, 2, 2));
+    raytracer::Sphere *s = new raytracer::Sphere();
+    s->setTransform(raytracer::Matrix4::translation(5, 0, 0));
+    group.add(s);
+    raytracer::Ray ray(raytracer::Point(10, 0, -10), raytracer::Vector(0, 0, 1));
+    ASSERT_TRUE(group.occluded(ray, 9));
+    ASSERT_FALSE(group.occluded(ray, 8));
+    ASSERT_FALSE(group.occluded(raytracer::Ray(raytracer::Point(0, 0, -10), raytracer::Vector(0, 0, 1)), 100));
+}
+
+// A committed group hits and shades like the uncommitted one
+TEST_F(GroupTest, A_committed_group_hits_and_shades_like_the_uncommitted_one)
+{
+    raytracer::Shape *hexagon = raytracer::Group::Hexagon();
+    hexagon->setTransform(raytracer::Matrix4::translation(0, 0.5, 0) * raytracer::Matrix4::rotationX(0.4) * raytracer::Matrix4::scaling(2, 2, 2));
+
+    std::vector<raytracer::Ray> rays;
+    raytracer::Point eye(0, 10, -10);
+    for (int i = 0; i < 20; ++i)
+        for (int j = 0; j < 20; ++j)
+            rays.push_back(raytracer::Ray(eye, (raytracer::Point(-2.5 + 0.25 * i, 0.5, -2.5 + 0.25 * j) - eye).normalize()));
+
+    struct Hit {
+        double t;
+        const raytracer::Shape *shape;
+        raytracer::Tuple normal;
+    };
+    auto trace = [&]() {
+        std::vector<Hit> hits;
+        for (const auto &ray : rays) {
+            auto hit = hexagon->closestHit(ray, 0, std::numeric_limits<double>::infinity());
+            if (hit)
+                hits.push_back({hit->t(), &hit->shape(), hit->shape().normalAt(ray.position(hit->t()), *hit)});
+            else
+                hits.push_back({-1, nullptr, raytracer::Vector(0, 0, 0)});
+        }
+        return hits;
+    };
+
+    auto before = trace();
+    hexagon->commit(raytracer::Matrix4::identity());
+    ASSERT_TRUE(static_cast<raytracer::AShape *>(hexagon)->committed());
+    auto after = trace();
+
+    // Where a corner and an edge meet, rounding may pick either one.
+    int hits = 0;
+    for (std::size_t i = 0; i < rays.size(); ++i) {
+        ASSERT_NEAR(after[i].t, before[i].t, 1e-9);
+        if (after[i].shape == before[i].shape) {
+            ASSERT_TRUE(after[i].normal == before[i].normal);
+            hits += before[i].shape != nullptr;
+        }
+    }
+    EXPECT_GT(hits, 50);
+    delete hexagon;
+}
+
+// Changing a transform after a commit goes back to walking the parents
+TEST_F(GroupTest, Changing_a_transform_after_a_commit_goes_back_to_walking_the_parents)
+{
+    raytracer::Group group;
+    group.setTransform(raytracer::Matrix4::scaling(2, 2, 2));
+    raytracer::Sphere *s = new raytracer::Sphere();
+    s->setTransform(raytracer::Matrix4::translation(5, 0, 0));
+    group.add(s);
+    group.commit(raytracer::Matrix4::identity());
+    ASSERT_TRUE(s->committed());
+    ASSERT_TRUE(s->worldToObject(raytracer::Point(10, 0, 0)) == raytracer::Point(0, 0, 0));
+
+    group.setTransform(raytracer::Matrix4::translation(1, 0, 0));
+    ASSERT_FALSE(s->committed());
+    ASSERT_TRUE(s->worldToObject(raytracer::Point(6, 0, 0)) == raytracer::Point(0, 0, 0));
+    raytracer::Ray ray(raytracer::Point(6, 0, -10), raytracer::Vector(0, 0, 1));
+    ASSERT_EQ(group.intersect(ray).count(), 2);
+    ASSERT_EQ(group.intersect(raytracer::Ray(raytracer::Point(10, 0, -10), raytracer::Vector(0, 0, 1))).count(), 0);
+}
+
+// A group's bounds hold its children's transformed bounds
+TEST_F(GroupTest, A_groups_bounds_hold_its_childrens_transformed_bounds)
+{
+    raytracer::Group group;
+    ASSERT_TRUE(group.bounds().empty());
+
+    raytracer::Sphere *s = new raytracer::Sphere();
+    s->setTransform(raytracer::Matrix4::translation(2, 5, -3) * raytracer::Matrix4::scaling(2, 2, 2));
+    group.add(s);
+    raytracer::Group *inner = new raytracer::Group();
+    inner->setTransform(raytracer::Matrix4::rotationZ(M_PI / 2));
+    raytracer::Cylinder *c = new raytracer::Cylinder();
+    c->minimum = 0;
+    c->maximum = 3;
+    inner->add(c);
+    group.add(inner);
+
+    auto b = group.bounds();
+    ASSERT_TRUE(b.min == raytracer::Point(-3, -1, -5));
+    ASSERT_TRUE(b.max == raytracer::Point(4, 7, 1));
+
+    s->setTransform(raytracer::Matrix4::translation(0, 10, 0));
+    b = group.bounds();
+    ASSERT_TRUE(b.min == raytracer::Point(-3, -1, -1));
+    ASSERT_TRUE(b.max == raytracer::Point(1, 11, 1));
+}
+
+// A ray missing a group's box never reaches its children
+TEST_F(GroupTest, A_ray_missing_a_groups_box_never_reaches_its_children)
+{
+    raytracer::Group group;
+    group.setTransform(raytracer::Matrix4::scaling(2, 2, 2));
+    CountingSphere *s = new CountingSphere();
+    s->setTransform(raytracer::Matrix4::translation(5, 0, 0));
+    group.add(s);
+
+    raytracer::Ray miss(raytracer::Point(0, 0, -10), raytracer::Vector(0, 0, 1));
+    raytracer::Ray hit(raytracer::Point(10, 0, -10), raytracer::Vector(0, 0, 1));
+    for (int pass = 0; pass < 2; ++pass) {
+        s->calls = 0;
+        EXPECT_EQ(group.intersect(miss).count(), 0);
+        EXPECT_FALSE(group.occluded(miss, 100));
+        EXPECT_FALSE(group.closestHit(miss, 0, 100).has_value());
+        EXPECT_EQ(s->calls, 0);
+
+        // Boxes behind the ray or past the closest hit are skipped as well.
+        EXPECT_FALSE(group.occluded(hit, 5));
+        EXPECT_FALSE(group.closestHit(hit, 20, 100).has_value());
+        EXPECT_EQ(s->calls, 0);
+
+        EXPECT_EQ(group.intersect(hit).count(), 2);
+        EXPECT_TRUE(group.occluded(hit, 100));
+        EXPECT_TRUE(group.closestHit(hit, 0, 100).has_value());
+        EXPECT_EQ(s->calls, 3);
+
+        // The second pass goes through the world bounds of a committed group.
+        group.commit(raytracer::Matrix4::identity());
+    }
+}
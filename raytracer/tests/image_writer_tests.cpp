@@ -0,0 +1,156 @@
+#include "raytracer.hpp"
+
+#include <gmock/gmock.h>
+
+#include <cstdio>
+#include <cstring>
+
+class ImageWriterTest : public testing::Test {};
+
+// Encodes the canvas through a temporary file and returns the bytes.
+static std::string encode(const raytracer::Canvas &canvas, raytracer::ImageFormat format, std::size_t *written = nullptr)
+{
+    std::FILE *file = std::tmpfile();
+    std::size_t n = raytracer::ImageWriter::Write(canvas, fileno(file), format);
+    if (written)
+        *written = n;
+    std::string bytes(n, '\0');
+    std::rewind(file);
+    bytes.resize(std::fread(bytes.data(), 1, n, file));
+    std::fclose(file);
+    return bytes;
+}
+
+static std::uint32_t bigEndian(const std::string &bytes, std::size_t at)
+{
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(bytes.data() + at);
+    return (std::uint32_t(p[0]) << 24) | (std::uint32_t(p[1]) << 16) | (std::uint32_t(p[2]) << 8) | p[3];
+}
+
+// Filtered scanlines of a PNG: walks the chunks, checks their CRC and
+// inflates the stored deflate blocks of the IDAT stream.
+static std::string pngScanlines(const std::string &png)
+{
+    std::string zlib;
+    std::size_t at = 8;
+    while (at < png.size()) {
+        std::uint32_t length = bigEndian(png, at);
+        std::string type = png.substr(at + 4, 4);
+        EXPECT_EQ(raytracer::ImageWriter::Crc32(png.data() + at + 4, 4 + length), bigEndian(png, at + 8 + length));
+        if (type == "IDAT")
+            zlib += png.substr(at + 8, length);
+        at += 12 + length;
+    }
+
+    std::string raw;
+    std::size_t p = 2;
+    for (bool last = false; !last;) {
+        last = zlib[p] & 1;
+        std::size_t length = static_cast<unsigned char>(zlib[p + 1]) | static_cast<unsigned char>(zlib[p + 2]) << 8;
+        raw += zlib.substr(p + 5, length);
+        p += 5 + length;
+    }
+    EXPECT_EQ(raytracer::ImageWriter::Adler32(raw.data(), raw.size()), bigEndian(zlib, p));
+    EXPECT_EQ(p + 4, zlib.size());
+    return raw;
+}
+
+// Checksums match their reference values
+TEST_F(ImageWriterTest, Checksums_match_their_reference_values)
+{
+    EXPECT_EQ(raytracer::ImageWriter::Crc32("IEND", 4), 0xae426082u);
+    EXPECT_EQ(raytracer::ImageWriter::Crc32("123456789", 9), 0xcbf43926u);
+    EXPECT_EQ(raytracer::ImageWriter::Adler32("Wikipedia", 9), 0x11e60398u);
+    EXPECT_EQ(raytracer::ImageWriter::Crc32("6789", 4, raytracer::ImageWriter::Crc32("12345", 5)), 0xcbf43926u);
+}
+
+// A P6 image holds the header and one byte per channel
+TEST_F(ImageWriterTest, A_P6_image_holds_the_header_and_one_byte_per_channel)
+{
+    raytracer::Canvas c(5, 3);
+    c.writePixel(0, 0, raytracer::Color(1.5, 0, 0));
+    c.writePixel(2, 1, raytracer::Color(0, 0.5, 0));
+    c.writePixel(4, 2, raytracer::Color(-0.5, 0, 1));
+    std::size_t written;
+    std::string ppm = encode(c, raytracer::ImageFormat::PPM, &written);
+
+    std::string header = "P6\n5 3\n255\n";
+    ASSERT_EQ(ppm.size(), header.size() + 5 * 3 * 3);
+    EXPECT_EQ(written, ppm.size());
+    EXPECT_EQ(ppm.substr(0, header.size()), header);
+    const unsigned char *pixels = reinterpret_cast<const unsigned char *>(ppm.data() + header.size());
+    EXPECT_EQ(pixels[0], 255);
+    EXPECT_EQ(pixels[(1 * 5 + 2) * 3 + 1], 128);
+    EXPECT_EQ(pixels[(2 * 5 + 4) * 3 + 0], 0);
+    EXPECT_EQ(pixels[(2 * 5 + 4) * 3 + 2], 255);
+}
+
+// A PFM image stores float rows from the bottom up
+TEST_F(ImageWriterTest, A_PFM_image_stores_float_rows_from_the_bottom_up)
+{
+    for (auto format : {raytracer::PixelFormat::RGB32F, raytracer::PixelFormat::RGBA32F, raytracer::PixelFormat::RGB64F}) {
+        raytracer::Canvas c(4, 2, format);
+        c.writePixel(1, 0, raytracer::Color(0.25, 2.5, -1));
+        std::string pfm = encode(c, raytracer::ImageFormat::PFM);
+
+        std::string header = "PF\n4 2\n-1.0\n";
+        ASSERT_EQ(pfm.size(), header.size() + 4 * 2 * 3 * sizeof(float));
+        EXPECT_EQ(pfm.substr(0, header.size()), header);
+        float pixel[3];
+        std::memcpy(pixel, pfm.data() + header.size() + (4 + 1) * 3 * sizeof(float), sizeof(pixel));
+        EXPECT_EQ(pixel[0], 0.25f);
+        EXPECT_EQ(pixel[1], 2.5f);
+        EXPECT_EQ(pixel[2], -1.0f);
+    }
+}
+
+// A PNG image holds unfiltered scanlines in stored blocks
+TEST_F(ImageWriterTest, A_PNG_image_holds_unfiltered_scanlines_in_stored_blocks)
+{
+    raytracer::Canvas c(3, 2);
+    c.writePixel(2, 1, raytracer::Color(1, 0.5, 0));
+    std::string png = encode(c, raytracer::ImageFormat::PNG);
+
+    EXPECT_EQ(png.substr(0, 8), std::string("\x89PNG\r\n\x1a\n", 8));
+    EXPECT_EQ(png.substr(12, 4), "IHDR");
+    EXPECT_EQ(bigEndian(png, 16), 3);
+    EXPECT_EQ(bigEndian(png, 20), 2);
+    EXPECT_EQ(png.substr(png.size() - 8, 4), "IEND");
+
+    std::string expected(2 * (1 + 3 * 3), '\0');
+    expected[10 + 1 + 6] = '\xff';
+    expected[10 + 1 + 7] = '\x80';
+    EXPECT_EQ(pngScanlines(png), expected);
+}
+
+// Large PNG images are split across several stored blocks
+TEST_F(ImageWriterTest, Large_PNG_images_are_split_across_several_stored_blocks)
+{
+    raytracer::Canvas c(200, 120);
+    for (int y = 0; y < c.height(); y++)
+        for (int x = 0; x < c.width(); x++)
+            c.writePixel(x, y, raytracer::Color(x / 200.0, y / 120.0, 0.5));
+    std::string raw = pngScanlines(encode(c, raytracer::ImageFormat::PNG));
+
+    ASSERT_EQ(raw.size(), 120 * (1 + 3 * 200));
+    std::size_t row = 1 + 3 * 200;
+    EXPECT_EQ(raw[119 * row], 0);
+    EXPECT_EQ(static_cast<unsigned char>(raw[119 * row + 1 + 3 * 199]), static_cast<int>(199 / 200.0 * 256));
+    EXPECT_EQ(static_cast<unsigned char>(raw[119 * row + 1 + 3 * 199 + 1]), static_cast<int>(119 / 120.0 * 256));
+}
+
+// The format follows the file extension
+TEST_F(ImageWriterTest, The_format_follows_the_file_extension)
+{
+    EXPECT_EQ(raytracer::ImageWriter::FormatForPath("frame.ppm"), raytracer::ImageFormat::PPM);
+    EXPECT_EQ(raytracer::ImageWriter::FormatForPath("out/frame.pfm"), raytracer::ImageFormat::PFM);
+    EXPECT_EQ(raytracer::ImageWriter::FormatForPath("frame.png"), raytracer::ImageFormat::PNG);
+    EXPECT_THROW(raytracer::ImageWriter::FormatForPath("frame.jpg"), std::invalid_argument);
+}
+
+// Writing to a closed descriptor throws
+TEST_F(ImageWriterTest, Writing_to_a_closed_descriptor_throws)
+{
+    raytracer::Canvas c(4, 4);
+    EXPECT_THROW(raytracer::ImageWriter::WritePPM(c, -1), std::runtime_error);
+}
@@ -13,6 +13,15 @@ TEST_F(IntersectionsTest, An_intersection_encapsulates_t_and_object)
     EXPECT_TRUE(&i.shape() == &s);
 }
 
+// An intersection can encapsulate u and v
+TEST_F(IntersectionsTest, An_intersection_can_encapsulate_u_and_v)
+{
+    raytracer::Triangle s(raytracer::Point(0, 1, 0), raytracer::Point(-1, 0, 0), raytracer::Point(1, 0, 0));
+    raytracer::Intersection i(3.5, s, 0.2, 0.4);
+    EXPECT_TRUE(double_equals(i.u(), 0.2));
+    EXPECT_TRUE(double_equals(i.v(), 0.4));
+}
+
 // Aggregating intersections
 TEST_F(IntersectionsTest, Aggregating_intersections)
 {
@@ -25,6 +34,35 @@ TEST_F(IntersectionsTest, Aggregating_intersections)
     EXPECT_TRUE(double_equals(xs[1].t(), 2));
 }
 
+// Sorting intersections orders them by t
+TEST_F(IntersectionsTest, Sorting_intersections_orders_them_by_t)
+{
+    raytracer::Sphere s;
+    for (int n : {5, 40}) {
+        std::vector<raytracer::Intersection> values;
+        for (int i = 0; i < n; ++i)
+            values.emplace_back((i * 7919) % n - n / 2, s);
+        raytracer::Intersections xs(values);
+        xs.sort();
+        ASSERT_EQ(xs.count(), n);
+        for (int i = 1; i < n; ++i)
+            ASSERT_LE(xs[i - 1].t(), xs[i].t());
+    }
+}
+
+// Merging intersections keeps them sorted
+TEST_F(IntersectionsTest, Merging_intersections_keeps_them_sorted)
+{
+    raytracer::Sphere s;
+    raytracer::Intersections xs({raytracer::Intersection(-1, s), raytracer::Intersection(4, s)});
+    xs.merge(raytracer::Intersections({raytracer::Intersection(6, s), raytracer::Intersection(2, s), raytracer::Intersection(-3, s)}));
+    xs.insert(raytracer::Intersection(5, s));
+    ASSERT_EQ(xs.count(), 6);
+    double expected[] = {-3, -1, 2, 4, 5, 6};
+    for (int i = 0; i < 6; ++i)
+        ASSERT_EQ(xs[i].t(), expected[i]);
+}
+
 // The hit, when all intersections have positive t
 TEST_F(IntersectionsTest, The_hit_when_all_intersections_have_positive_t)
 {
@@ -113,7 +151,7 @@ TEST_F(IntersectionsTest, The_hit_should_offset_the_point)
 {
     raytracer::Ray r(raytracer::Point(0, 0, -5), raytracer::Vector(0, 0, 1));
     raytracer::Sphere s;
-    s.transform() = raytracer::Matrix::translation(0, 0, 1);
+    s.setTransform(raytracer::Matrix4::translation(0, 0, 1));
     raytracer::Intersection i(5, s);
     raytracer::Computations comps = i.prepareComputations(r, raytracer::Intersections{i});
     EXPECT_TRUE(comps.overPoint.z < -EPSILON / 2);
@@ -134,15 +172,15 @@ TEST_F(IntersectionsTest, Precomputing_the_reflection_vector)
 TEST_F(IntersectionsTest, Finding_n1_and_n2_at_various_intersections)
 {
     raytracer::GlassSphere A;
-    A.transform() = raytracer::Matrix::scaling(2, 2, 2);
+    A.setTransform(raytracer::Matrix4::scaling(2, 2, 2));
     A.material().refractiveIndex = 1.5;
 
     raytracer::GlassSphere B;
-    B.transform() = raytracer::Matrix::translation(0, 0, -0.25);
+    B.setTransform(raytracer::Matrix4::translation(0, 0, -0.25));
     B.material().refractiveIndex = 2.0;
 
     raytracer::GlassSphere C;
-    C.transform() = raytracer::Matrix::translation(0, 0, 0.25);
+    C.setTransform(raytracer::Matrix4::translation(0, 0, 0.25));
     C.material().refractiveIndex = 2.5;
 
     raytracer::Ray r(raytracer::Point(0, 0, -4), raytracer::Vector(0, 0, 1));
@@ -179,12 +217,46 @@ TEST_F(IntersectionsTest, Finding_n1_and_n2_at_various_intersections)
     }
 }
 
+// A container tracker follows nested shapes
+TEST_F(IntersectionsTest, A_container_tracker_follows_nested_shapes)
+{
+    raytracer::GlassSphere A;
+    A.material().refractiveIndex = 1.5;
+    raytracer::GlassSphere B;
+    B.material().refractiveIndex = 2.0;
+
+    raytracer::ContainerTracker containers;
+    EXPECT_EQ(containers.refractiveIndex(), 1.0);
+    containers.toggle(A);
+    EXPECT_EQ(containers.refractiveIndex(), 1.5);
+    containers.toggle(B);
+    EXPECT_EQ(containers.refractiveIndex(), 2.0);
+    containers.toggle(A);
+    EXPECT_EQ(containers.depth(), 1);
+    EXPECT_EQ(containers.refractiveIndex(), 2.0);
+    containers.toggle(B);
+    EXPECT_EQ(containers.depth(), 0);
+    EXPECT_EQ(containers.refractiveIndex(), 1.0);
+}
+
+// Preparing an opaque hit without the intersection list
+TEST_F(IntersectionsTest, Preparing_an_opaque_hit_without_the_intersection_list)
+{
+    raytracer::Ray r(raytracer::Point(0, 0, -5), raytracer::Vector(0, 0, 1));
+    raytracer::Sphere s;
+    raytracer::Intersection i(4, s);
+    raytracer::Computations comps = i.prepareComputations(r);
+    EXPECT_TRUE(comps.point == raytracer::Point(0, 0, -1));
+    EXPECT_EQ(comps.n1, 1.0);
+    EXPECT_EQ(comps.n2, 1.0);
+}
+
 // The under point is offset below the surface
 TEST_F(IntersectionsTest, The_under_point_is_offset_below_the_surface)
 {
     raytracer::Ray r(raytracer::Point(0, 0, -5), raytracer::Vector(0, 0, 1));
     raytracer::GlassSphere s;
-    s.transform() = raytracer::Matrix::translation(0, 0, 1);
+    s.setTransform(raytracer::Matrix4::translation(0, 0, 1));
     raytracer::Intersection i(5, s);
     raytracer::Computations comps = i.prepareComputations(r, raytracer::Intersections{i});
     EXPECT_TRUE(comps.underPoint.z > EPSILON / 2);
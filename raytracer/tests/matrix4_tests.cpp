@@ -0,0 +1,100 @@
+#include "raytracer.hpp"
+
+#include <gmock/gmock.h>
+
+class Matrix4Test : public testing::Test {};
+
+// A Matrix4 is built from a 4x4 Matrix
+TEST_F(Matrix4Test, A_Matrix4_is_built_from_a_4x4_Matrix)
+{
+    raytracer::Matrix4 m(raytracer::Matrix::translation(1, 2, 3));
+    EXPECT_EQ(m[0][3], 1);
+    EXPECT_EQ(m[1][3], 2);
+    EXPECT_EQ(m[2][3], 3);
+    EXPECT_TRUE(m == raytracer::Matrix4(raytracer::Matrix::translation(1, 2, 3)));
+    EXPECT_TRUE(static_cast<raytracer::Matrix>(m) == raytracer::Matrix::translation(1, 2, 3));
+    EXPECT_TRUE(raytracer::Matrix4::translation(1, 2, 3) == m);
+}
+
+// The identity is usable in constant expressions
+TEST_F(Matrix4Test, The_identity_is_usable_in_constant_expressions)
+{
+    constexpr raytracer::Matrix4 id = raytracer::Matrix4::identity();
+    static_assert(id.determinant() == 1);
+    static_assert(id.isAffine());
+    static_assert(id.inverse()[2][2] == 1);
+    EXPECT_TRUE(id == raytracer::Matrix4(raytracer::Matrix::identity(4)));
+}
+
+// Multiplying two matrices
+TEST_F(Matrix4Test, Multiplying_two_matrices)
+{
+    raytracer::Matrix4 a({1, 2, 3, 4,
+                          5, 6, 7, 8,
+                          9, 8, 7, 6,
+                          5, 4, 3, 2});
+    raytracer::Matrix4 b({-2, 1, 2, 3,
+                          3, 2, 1, -1,
+                          4, 3, 6, 5,
+                          1, 2, 7, 8});
+    raytracer::Matrix4 c({20, 22, 50, 48,
+                          44, 54, 114, 108,
+                          40, 58, 110, 102,
+                          16, 26, 46, 42});
+    EXPECT_TRUE(a * b == c);
+}
+
+// A matrix multiplied by a tuple
+TEST_F(Matrix4Test, A_matrix_multiplied_by_a_tuple)
+{
+    raytracer::Matrix4 a({1, 2, 3, 4,
+                          2, 4, 4, 2,
+                          8, 6, 4, 1,
+                          0, 0, 0, 1});
+    EXPECT_TRUE(a * raytracer::Tuple(1, 2, 3, 1) == raytracer::Tuple(18, 24, 33, 1));
+}
+
+// Calculating the determinant of a 4x4 matrix
+TEST_F(Matrix4Test, Calculating_the_determinant_of_a_4x4_matrix)
+{
+    raytracer::Matrix4 a({-2, -8, 3, 5,
+                          -3, 1, 7, 3,
+                          1, 2, -9, 6,
+                          -6, 7, 7, -9});
+    EXPECT_EQ(a.determinant(), -4071);
+    EXPECT_TRUE(a.isInvertible());
+
+    raytracer::Matrix4 b({-4, 2, -2, -3,
+                          9, 6, 2, 6,
+                          0, -5, 1, -5,
+                          0, 0, 0, 0});
+    EXPECT_EQ(b.determinant(), 0);
+    EXPECT_FALSE(b.isInvertible());
+}
+
+// The closed-form inverse matches the cofactor inverse
+TEST_F(Matrix4Test, The_closed_form_inverse_matches_the_cofactor_inverse)
+{
+    double values[][16] = {
+        {-5, 2, 6, -8, 1, -5, 1, 8, 7, 7, -6, -7, 1, -3, 7, 4},
+        {8, -5, 9, 2, 7, 5, 6, 1, -6, 0, 9, 6, -3, 0, -9, -4},
+        {9, 3, 0, 9, -5, -2, -6, -3, -4, 9, 6, 4, -7, 6, 6, 2},
+    };
+
+    for (auto &v : values) {
+        raytracer::Matrix m(4, 4, v);
+        raytracer::Matrix4 m4(v);
+        EXPECT_FALSE(m4.isAffine());
+        EXPECT_TRUE(m4.inverse() == raytracer::Matrix4(m.inverse()));
+        EXPECT_TRUE(m4.generalInverse() == raytracer::Matrix4(m.inverse()));
+    }
+}
+
+// The affine inverse matches the general inverse
+TEST_F(Matrix4Test, The_affine_inverse_matches_the_general_inverse)
+{
+    raytracer::Matrix4 m = raytracer::Matrix4::translation(1, -2, 3) * raytracer::Matrix4::rotationY(M_PI / 5) * raytracer::Matrix4::shearing(1, 0, 0.5, 0, 0, 2) * raytracer::Matrix4::scaling(2, 0.5, 3);
+    EXPECT_TRUE(m.isAffine());
+    EXPECT_TRUE(m.affineInverse() == m.generalInverse());
+    EXPECT_TRUE(m * m.inverse() == raytracer::Matrix4::identity());
+}
@@ -0,0 +1,130 @@
+#include "raytracer.hpp"
+
+#include <gmock/gmock.h>
+
+#include <filesystem>
+#include <unistd.h>
+
+// Each test works in a directory of its own, removed afterwards.
+class MeshCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        const auto *info = ::testing::UnitTest::GetInstance()->current_test_info();
+        directory = std::filesystem::temp_directory_path() / ("mesh_cache_" + std::to_string(::getpid()) + "_" + info->name());
+        std::filesystem::create_directories(directory);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(directory); }
+
+    std::string path(const std::string &name) const { return (directory / name).string(); }
+
+    static void write(const std::string &filePath, const std::string &content) { std::ofstream(filePath, std::ios::binary) << content; }
+
+    std::filesystem::path directory;
+};
+
+static const char *square = "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nvt 0 0\nvn 0 0 -1\nf 1/1/1 2/1/1 3/1/1 4/1/1\n";
+
+// A saved mesh loads back with the same arrays and hierarchy
+TEST_F(MeshCacheTest, A_saved_mesh_loads_back_with_the_same_arrays_and_hierarchy)
+{
+    raytracer::TriangleMesh mesh(raytracer::OBJLoader::LoadFile(RAYTRACER_TEAPOT_OBJ));
+    raytracer::MeshCache::Save(mesh, path("teapot.rtmesh"), 42);
+
+    auto loaded = raytracer::MeshCache::Load(path("teapot.rtmesh"), 42);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->mesh().positions, mesh.mesh().positions);
+    EXPECT_EQ(loaded->mesh().positionIndices, mesh.mesh().positionIndices);
+    EXPECT_EQ(loaded->tree().indices(), mesh.tree().indices());
+    ASSERT_EQ(loaded->tree().nodes().size(), mesh.tree().nodes().size());
+    EXPECT_EQ(std::memcmp(loaded->tree().nodes().data(), mesh.tree().nodes().data(), mesh.tree().nodes().size() * sizeof(raytracer::LinearBVH::Node)), 0);
+
+    raytracer::Ray r(raytracer::Point(0, 3, -5), raytracer::Vector(0, -0.5, 1).normalize());
+    auto expected = mesh.closestHit(r, 0, std::numeric_limits<double>::infinity());
+    auto hit = loaded->closestHit(r, 0, std::numeric_limits<double>::infinity());
+    ASSERT_TRUE(expected.has_value() && hit.has_value());
+    EXPECT_EQ(hit->t(), expected->t());
+    EXPECT_EQ(hit->primitive(), expected->primitive());
+}
+
+// Optional arrays and an empty mesh survive the round trip
+TEST_F(MeshCacheTest, Optional_arrays_and_an_empty_mesh_survive_the_round_trip)
+{
+    raytracer::TriangleMesh mesh(raytracer::OBJLoader::Parse(square));
+    raytracer::MeshCache::Save(mesh, path("square.rtmesh"), 1);
+    auto loaded = raytracer::MeshCache::Load(path("square.rtmesh"), 1);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->size(), 2);
+    EXPECT_EQ(loaded->mesh().texcoords, mesh.mesh().texcoords);
+    EXPECT_EQ(loaded->mesh().normals, mesh.mesh().normals);
+    EXPECT_EQ(loaded->mesh().texcoordIndices, mesh.mesh().texcoordIndices);
+    EXPECT_EQ(loaded->mesh().normalIndices, mesh.mesh().normalIndices);
+
+    raytracer::MeshCache::Save(raytracer::TriangleMesh(raytracer::MeshData()), path("empty.rtmesh"), 1);
+    auto empty = raytracer::MeshCache::Load(path("empty.rtmesh"), 1);
+    ASSERT_TRUE(empty.has_value());
+    EXPECT_EQ(empty->size(), 0);
+    EXPECT_TRUE(empty->tree().empty());
+}
+
+// Missing, stale and damaged caches are not loaded
+TEST_F(MeshCacheTest, Missing_stale_and_damaged_caches_are_not_loaded)
+{
+    EXPECT_FALSE(raytracer::MeshCache::Load(path("missing.rtmesh"), 1).has_value());
+
+    raytracer::MeshCache::Save(raytracer::TriangleMesh(raytracer::OBJLoader::Parse(square)), path("square.rtmesh"), 1);
+    EXPECT_FALSE(raytracer::MeshCache::Load(path("square.rtmesh"), 2).has_value());
+
+    std::filesystem::resize_file(path("square.rtmesh"), std::filesystem::file_size(path("square.rtmesh")) - 1);
+    EXPECT_FALSE(raytracer::MeshCache::Load(path("square.rtmesh"), 1).has_value());
+
+    write(path("garbage.rtmesh"), std::string(4096, 'x'));
+    EXPECT_FALSE(raytracer::MeshCache::Load(path("garbage.rtmesh"), 1).has_value());
+}
+
+// The key follows the source bytes and the build parameters
+TEST_F(MeshCacheTest, The_key_follows_the_source_bytes_and_the_build_parameters)
+{
+    std::string source = square;
+    std::uint64_t key = raytracer::MeshCache::Key(source, 4);
+    EXPECT_EQ(raytracer::MeshCache::Key(source, 4), key);
+    EXPECT_NE(raytracer::MeshCache::Key(source, 2), key);
+
+    for (std::size_t i = 0; i < source.size(); ++i) {
+        std::string edited = source;
+        edited[i] ^= 1;
+        EXPECT_NE(raytracer::MeshCache::Key(edited, 4), key) << "byte " << i;
+    }
+    EXPECT_NE(raytracer::MeshCache::Key(source + "\n", 4), key);
+}
+
+// Loading an OBJ file writes the cache, then reads it until the file changes
+TEST_F(MeshCacheTest, Loading_an_OBJ_file_writes_the_cache_then_reads_it_until_the_file_changes)
+{
+    write(path("shape.obj"), square);
+    raytracer::TriangleMesh first = raytracer::MeshCache::LoadFile(path("shape.obj"));
+    EXPECT_EQ(first.size(), 2);
+    ASSERT_TRUE(std::filesystem::exists(path("shape.obj.rtmesh")));
+
+    // A cache read back is the one saved: pass its key explicitly.
+    std::uint64_t key = raytracer::MeshCache::Key(square, 4);
+    EXPECT_TRUE(raytracer::MeshCache::Load(path("shape.obj.rtmesh"), key).has_value());
+    EXPECT_EQ(raytracer::MeshCache::LoadFile(path("shape.obj")).size(), 2);
+
+    write(path("shape.obj"), "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n");
+    EXPECT_EQ(raytracer::MeshCache::LoadFile(path("shape.obj")).size(), 1);
+    EXPECT_FALSE(raytracer::MeshCache::Load(path("shape.obj.rtmesh"), key).has_value());
+
+    EXPECT_EQ(raytracer::MeshCache::LoadFile(path("shape.obj"), path("other.rtmesh"), 1).size(), 1);
+    EXPECT_TRUE(std::filesystem::exists(path("other.rtmesh")));
+}
+
+// A cache that cannot be written does not fail the load
+TEST_F(MeshCacheTest, A_cache_that_cannot_be_written_does_not_fail_the_load)
+{
+    write(path("shape.obj"), square);
+    EXPECT_EQ(raytracer::MeshCache::LoadFile(path("shape.obj"), path("missing/shape.rtmesh")).size(), 2);
+    EXPECT_THROW(raytracer::MeshCache::Save(raytracer::TriangleMesh(raytracer::MeshData()), path("missing/shape.rtmesh"), 1), std::runtime_error);
+    EXPECT_THROW(raytracer::MeshCache::LoadFile(path("missing.obj")), std::runtime_error);
+}
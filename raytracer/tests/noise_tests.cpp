@@ -0,0 +1,74 @@
+#include "raytracer.hpp"
+
+#include <gmock/gmock.h>
+
+class PerlinNoiseTest : public ::testing::Test {};
+
+// Noise is zero on every lattice point
+TEST_F(PerlinNoiseTest, Noise_is_zero_on_every_lattice_point)
+{
+    for (int x = -3; x <= 3; ++x)
+        for (int y = -3; y <= 3; ++y)
+            for (int z = -3; z <= 3; ++z)
+                EXPECT_EQ(raytracer::PerlinNoise::Noise(x, y, z), 0);
+}
+
+// Noise keeps the values of the pattern's original permutation
+TEST_F(PerlinNoiseTest, Noise_keeps_the_values_of_the_patterns_original_permutation)
+{
+    EXPECT_DOUBLE_EQ(raytracer::PerlinNoise::Noise(0.5, 0.5, 0.5), -0.25);
+    EXPECT_DOUBLE_EQ(raytracer::PerlinNoise::Noise(1.25, -2.5, 3.75), -0.091994285583496094);
+    EXPECT_DOUBLE_EQ(raytracer::PerlinNoise::Noise(-0.3, 0.7, 12.1), 0.058978697517081687);
+    EXPECT_DOUBLE_EQ(raytracer::PerlinNoise::Noise(raytracer::Point(100.6, -40.2, 0.01)), -0.13175644745817419);
+}
+
+// Noise stays within [-1, 1] and repeats every 256 units
+TEST_F(PerlinNoiseTest, Noise_stays_within_the_unit_range_and_repeats_every_256_units)
+{
+    for (int i = 0; i < 1000; ++i) {
+        double x = 0.37 * i - 150, y = 0.11 * i, z = -0.23 * i;
+        double n = raytracer::PerlinNoise::Noise(x, y, z);
+        EXPECT_LE(std::abs(n), 1);
+        EXPECT_NEAR(raytracer::PerlinNoise::Noise(x + 256, y - 256, z + 512), n, 1e-9);
+    }
+}
+
+// Fractal noise sums octaves of noise
+TEST_F(PerlinNoiseTest, Fractal_noise_sums_octaves_of_noise)
+{
+    raytracer::Point p(1.3, -0.4, 2.9);
+    EXPECT_EQ(raytracer::PerlinNoise::Fbm(p, 1), raytracer::PerlinNoise::Noise(p));
+    EXPECT_EQ(raytracer::PerlinNoise::Fbm(p, 0), 0);
+
+    double fbm = 0, turbulence = 0;
+    for (int i = 0; i < 3; ++i) {
+        double n = raytracer::PerlinNoise::Noise(p.x * std::pow(3, i), p.y * std::pow(3, i), p.z * std::pow(3, i));
+        fbm += std::pow(0.4, i) * n;
+        turbulence += std::pow(0.4, i) * std::abs(n);
+    }
+    EXPECT_NEAR(raytracer::PerlinNoise::Fbm(p, 3, 3, 0.4), fbm, 1e-12);
+    EXPECT_NEAR(raytracer::PerlinNoise::Turbulence(p, 3, 3, 0.4), turbulence, 1e-12);
+    EXPECT_GE(raytracer::PerlinNoise::Turbulence(p, 3, 3, 0.4), 0);
+}
+
+// Four points at once match four single evaluations
+TEST_F(PerlinNoiseTest, Four_points_at_once_match_four_single_evaluations)
+{
+    for (int i = 0; i < 100; ++i) {
+        double x[4], y[4], z[4], noise[4], fbm[4], turbulence[4];
+        for (int l = 0; l < 4; ++l) {
+            x[l] = 0.731 * (4 * i + l) - 90;
+            y[l] = -0.177 * (4 * i + l) + 3;
+            z[l] = 0.051 * (4 * i + l);
+        }
+        raytracer::PerlinNoise::Noise4(x, y, z, noise);
+        raytracer::PerlinNoise::Fbm4(x, y, z, fbm, 5);
+        raytracer::PerlinNoise::Turbulence4(x, y, z, turbulence, 5, 2.5, 0.6);
+        for (int l = 0; l < 4; ++l) {
+            raytracer::Point p(x[l], y[l], z[l]);
+            EXPECT_NEAR(noise[l], raytracer::PerlinNoise::Noise(p), 1e-12);
+            EXPECT_NEAR(fbm[l], raytracer::PerlinNoise::Fbm(p, 5), 1e-12);
+            EXPECT_NEAR(turbulence[l], raytracer::PerlinNoise::Turbulence(p, 5, 2.5, 0.6), 1e-12);
+        }
+    }
+}
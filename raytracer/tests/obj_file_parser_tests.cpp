@@ -83,3 +83,36 @@ TEST_F(OBJFileParserTest, TriangulatingPolygons)
     ASSERT_TRUE(parser.faces[2].p2 == parser.vertices[3]);
     ASSERT_TRUE(parser.faces[2].p3 == parser.vertices[4]);
 }
+
+// Faces with normals
+TEST_F(OBJFileParserTest, FacesWithNormals)
+{
+    std::stringstream objFileStream;
+    objFileStream << "v 0 1 0" << std::endl;
+    objFileStream << "v -1 0 0" << std::endl;
+    objFileStream << "v 1 0 0" << std::endl;
+    objFileStream << std::endl;
+    objFileStream << "vn -1 0 0" << std::endl;
+    objFileStream << "vn 1 0 0" << std::endl;
+    objFileStream << "vn 0 1 0" << std::endl;
+    objFileStream << std::endl;
+    objFileStream << "vt 0 0" << std::endl;
+    objFileStream << std::endl;
+    objFileStream << "f 1//3 2//1 3//2" << std::endl;
+    objFileStream << "f 1/1/3 2/1/1 3/1/2" << std::endl;
+    objFileStream << "f 1 2 3" << std::endl;
+
+    raytracer::OBJFileParser parser(raytracer::OBJFileParser::ParseString(objFileStream.str()));
+    ASSERT_TRUE(parser.normals.size() == 3);
+    ASSERT_TRUE(parser.smoothFaces.size() == 2);
+    ASSERT_TRUE(parser.faces.size() == 3);
+    ASSERT_EQ(parser.smoothIndices, (std::vector<std::size_t>{0, 1, raytracer::OBJFileParser::Flat}));
+    for (const auto &t : parser.smoothFaces) {
+        ASSERT_TRUE(t.p1 == parser.vertices[0]);
+        ASSERT_TRUE(t.p2 == parser.vertices[1]);
+        ASSERT_TRUE(t.p3 == parser.vertices[2]);
+        ASSERT_TRUE(t.n1 == parser.normals[2]);
+        ASSERT_TRUE(t.n2 == parser.normals[0]);
+        ASSERT_TRUE(t.n3 == parser.normals[1]);
+    }
+}
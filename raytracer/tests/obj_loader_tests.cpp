@@ -0,0 +1,154 @@
+#include "raytracer.hpp"
+
+#include <gmock/gmock.h>
+
+class OBJLoaderTest : public ::testing::Test {};
+
+// Vertex records fill flat arrays
+TEST_F(OBJLoaderTest, Vertex_records_fill_flat_arrays)
+{
+    raytracer::MeshData mesh = raytracer::OBJLoader::Parse(
+        "# comment\n"
+        "v -1 1 0\n"
+        "v -1.0000 0.5000 +2.5e-1\r\n"
+        "vt 0.25\n"
+        "vt 0.5 0.75 0\n"
+        "vn 0 0 1\n"
+        "vp 1 2 3\n"
+        "g group\n");
+    EXPECT_EQ(mesh.positions, (std::vector<double>{-1, 1, 0, -1, 0.5, 0.25}));
+    EXPECT_EQ(mesh.texcoords, (std::vector<double>{0.25, 0, 0.5, 0.75}));
+    EXPECT_EQ(mesh.normals, (std::vector<double>{0, 0, 1}));
+    EXPECT_EQ(mesh.triangleCount(), 0);
+}
+
+// Faces accept every corner form
+TEST_F(OBJLoaderTest, Faces_accept_every_corner_form)
+{
+    raytracer::MeshData mesh = raytracer::OBJLoader::Parse(
+        "v 0 0 0\nv 1 0 0\nv 0 1 0\n"
+        "vt 0 0\nvt 1 0\nvt 0 1\n"
+        "vn 0 0 1\nvn 0 0 -1\n"
+        "f 1/1/2 2/2/1 3/3/1\n"
+        "f 1//1 2//2 3//1\n"
+        "f 3/1 2/2 1/3\n");
+    EXPECT_EQ(mesh.positionIndices, (std::vector<std::uint32_t>{0, 1, 2, 0, 1, 2, 2, 1, 0}));
+    EXPECT_EQ(mesh.texcoordIndices, (std::vector<std::uint32_t>{0, 1, 2, raytracer::MeshData::None, raytracer::MeshData::None, raytracer::MeshData::None, 0, 1, 2}));
+    EXPECT_EQ(mesh.normalIndices, (std::vector<std::uint32_t>{1, 0, 0, 0, 1, 0, raytracer::MeshData::None, raytracer::MeshData::None, raytracer::MeshData::None}));
+}
+
+// Optional index arrays stay empty until a face uses them
+TEST_F(OBJLoaderTest, Optional_index_arrays_stay_empty_until_a_face_uses_them)
+{
+    raytracer::MeshData mesh = raytracer::OBJLoader::Parse(
+        "v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 1\n"
+        "f 1 2 3\n"
+        "f 1//1 2//1 3//1\n");
+    EXPECT_TRUE(mesh.texcoordIndices.empty());
+    EXPECT_EQ(mesh.normalIndices, (std::vector<std::uint32_t>{raytracer::MeshData::None, raytracer::MeshData::None, raytracer::MeshData::None, 0, 0, 0}));
+}
+
+// Negative indices count back from the latest record
+TEST_F(OBJLoaderTest, Negative_indices_count_back_from_the_latest_record)
+{
+    raytracer::MeshData mesh = raytracer::OBJLoader::Parse(
+        "v 0 0 0\nv 1 0 0\nv 0 1 0\n"
+        "f -3 -2 -1\n"
+        "v 1 1 0\n"
+        "f -3 -2 -1\n");
+    EXPECT_EQ(mesh.positionIndices, (std::vector<std::uint32_t>{0, 1, 2, 1, 2, 3}));
+}
+
+// Polygons are fanned around their first vertex
+TEST_F(OBJLoaderTest, Polygons_are_fanned_around_their_first_vertex)
+{
+    raytracer::MeshData mesh = raytracer::OBJLoader::Parse("v -1 1 0\nv -1 0 0\nv 1 0 0\nv 1 1 0\nv 0 2 0\nf 1 2 3 4 5");
+    EXPECT_EQ(mesh.positionIndices, (std::vector<std::uint32_t>{0, 1, 2, 0, 2, 3, 0, 3, 4}));
+}
+
+// Bad records throw with their line number
+TEST_F(OBJLoaderTest, Bad_records_throw_with_their_line_number)
+{
+    try {
+        raytracer::OBJLoader::Parse("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n");
+        FAIL() << "expected an exception";
+    } catch (const std::runtime_error &error) {
+        EXPECT_THAT(error.what(), testing::HasSubstr("line 4"));
+    }
+    EXPECT_THROW(raytracer::OBJLoader::Parse("v 0 zero 0\n"), std::runtime_error);
+    EXPECT_THROW(raytracer::OBJLoader::Parse("v 0 0 0\nf 0 1 1\n"), std::runtime_error);
+    EXPECT_THROW(raytracer::OBJLoader::Parse("v 0 0 0\nf 1 1\n"), std::runtime_error);
+    EXPECT_THROW(raytracer::OBJLoader::LoadFile("does/not/exist.obj"), std::runtime_error);
+}
+
+// Loading a file matches parsing its content
+TEST_F(OBJLoaderTest, Loading_a_file_matches_parsing_its_content)
+{
+    std::ifstream file(RAYTRACER_TEAPOT_OBJ);
+    std::stringstream content;
+    content << file.rdbuf();
+
+    raytracer::MeshData loaded = raytracer::OBJLoader::LoadFile(RAYTRACER_TEAPOT_OBJ);
+    raytracer::MeshData parsed = raytracer::OBJLoader::Parse(content.str());
+    EXPECT_EQ(loaded.vertexCount(), 3644);
+    EXPECT_EQ(loaded.triangleCount(), 6320);
+    EXPECT_EQ(loaded.positions, parsed.positions);
+    EXPECT_EQ(loaded.positionIndices, parsed.positionIndices);
+}
+
+static void expectSameMesh(const raytracer::MeshData &a, const raytracer::MeshData &b)
+{
+    EXPECT_EQ(a.positions, b.positions);
+    EXPECT_EQ(a.texcoords, b.texcoords);
+    EXPECT_EQ(a.normals, b.normals);
+    EXPECT_EQ(a.positionIndices, b.positionIndices);
+    EXPECT_EQ(a.texcoordIndices, b.texcoordIndices);
+    EXPECT_EQ(a.normalIndices, b.normalIndices);
+}
+
+// Parsing the teapot in chunks matches the serial parse
+TEST_F(OBJLoaderTest, Parsing_the_teapot_in_chunks_matches_the_serial_parse)
+{
+    raytracer::MappedFile file(RAYTRACER_TEAPOT_OBJ);
+    raytracer::MeshData serial = raytracer::OBJLoader::Parse(file.view(), 1);
+    for (int chunks : {2, 7, 64}) {
+        auto chunked = raytracer::OBJLoader::ParseChunks(file.view(), chunks);
+        ASSERT_TRUE(chunked.has_value()) << chunks << " chunks";
+        expectSameMesh(*chunked, serial);
+    }
+}
+
+// Negative indices are fixed up across chunk boundaries
+TEST_F(OBJLoaderTest, Negative_indices_are_fixed_up_across_chunk_boundaries)
+{
+    std::stringstream content;
+    for (int i = 0; i < 50; i++) {
+        content << "v " << i << " 0 0\nv " << i << " 1 0\nvn 0 0 1\nvt 0 " << i << "\n";
+        if (i % 3 == 2)
+            content << "vn 1 0 0\n";
+        if (i > 0)
+            content << "f -4/-2 -3/-1 -1/-1/-1 -2//-2\n";
+        if (i > 5)
+            content << "f 1 " << 2 * i << "//1 " << 2 * i - 1 << "\n";
+    }
+    raytracer::MeshData serial = raytracer::OBJLoader::Parse(content.str(), 1);
+    for (int chunks : {2, 3, 10, 200}) {
+        // Stitched in parallel, not rescued by the serial fallback.
+        auto chunked = raytracer::OBJLoader::ParseChunks(content.str(), chunks);
+        ASSERT_TRUE(chunked.has_value()) << chunks << " chunks";
+        expectSameMesh(*chunked, serial);
+    }
+}
+
+// Chunked parsing rejects what the serial parse rejects
+TEST_F(OBJLoaderTest, Chunked_parsing_rejects_what_the_serial_parse_rejects)
+{
+    std::string forward = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\nv 1 1 0\nv 2 2 0\nv 3 3 0\n";
+    std::string before = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf -1 -2 -3\nf -1 -2 -4\n";
+    for (int chunks : {1, 2, 4}) {
+        EXPECT_THROW(raytracer::OBJLoader::Parse(forward, chunks), std::runtime_error);
+        EXPECT_THROW(raytracer::OBJLoader::Parse(before, chunks), std::runtime_error);
+        EXPECT_FALSE(raytracer::OBJLoader::ParseChunks(forward, chunks + 1).has_value());
+        EXPECT_FALSE(raytracer::OBJLoader::ParseChunks(before, chunks + 1).has_value());
+    }
+}
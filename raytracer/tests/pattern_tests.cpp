@@ -66,7 +66,7 @@ TEST_F(PatternTest, A_stripe_pattern_alternates_in_x)
 TEST_F(PatternTest, Stripes_with_an_object_transformation)
 {
     raytracer::Sphere object;
-    object.transform() = raytracer::Matrix::scaling(2, 2, 2);
+    object.setTransform(raytracer::Matrix4::scaling(2, 2, 2));
     raytracer::StripePattern pattern(white, black);
     raytracer::Color c = pattern.patternAtShape(object, raytracer::Point(1.5, 0, 0));
     ASSERT_TRUE(c == white);
@@ -77,7 +77,7 @@ TEST_F(PatternTest, Stripes_with_a_pattern_transformation)
 {
     raytracer::Sphere object;
     raytracer::StripePattern pattern(white, black);
-    pattern.transform = raytracer::Matrix::scaling(2, 2, 2);
+    pattern.setTransform(raytracer::Matrix4::scaling(2, 2, 2));
     raytracer::Color c = pattern.patternAtShape(object, raytracer::Point(1.5, 0, 0));
     ASSERT_TRUE(c == white);
 }
@@ -86,9 +86,9 @@ TEST_F(PatternTest, Stripes_with_a_pattern_transformation)
 TEST_F(PatternTest, Stripes_with_both_an_object_and_a_pattern_transformation)
 {
     raytracer::Sphere object;
-    object.transform() = raytracer::Matrix::scaling(2, 2, 2);
+    object.setTransform(raytracer::Matrix4::scaling(2, 2, 2));
     raytracer::StripePattern pattern(white, black);
-    pattern.transform = raytracer::Matrix::translation(0.5, 0, 0);
+    pattern.setTransform(raytracer::Matrix4::translation(0.5, 0, 0));
     raytracer::Color c = pattern.patternAtShape(object, raytracer::Point(2.5, 0, 0));
     ASSERT_TRUE(c == white);
 }
@@ -110,22 +110,22 @@ public:
 TEST_F(PatternTest, The_default_pattern_transformation)
 {
     TestPattern pattern;
-    ASSERT_TRUE(pattern.transform == raytracer::Matrix::identity(4));
+    ASSERT_TRUE(pattern.transform() == raytracer::Matrix4::identity());
 }
 
 // Assigning a transformation
 TEST_F(PatternTest, Assigning_a_transformation)
 {
     TestPattern pattern;
-    pattern.transform = raytracer::Matrix::translation(1, 2, 3);
-    ASSERT_TRUE(pattern.transform == raytracer::Matrix::translation(1, 2, 3));
+    pattern.setTransform(raytracer::Matrix4::translation(1, 2, 3));
+    ASSERT_TRUE(pattern.transform() == raytracer::Matrix4::translation(1, 2, 3));
 }
 
 // A pattern with an object transformation
 TEST_F(PatternTest, A_pattern_with_an_object_transformation)
 {
     raytracer::Sphere object;
-    object.transform() = raytracer::Matrix::scaling(2, 2, 2);
+    object.setTransform(raytracer::Matrix4::scaling(2, 2, 2));
     TestPattern pattern;
     raytracer::Color c = pattern.patternAtShape(object, raytracer::Point(2, 3, 4));
     ASSERT_TRUE(c == raytracer::Color(1, 1.5, 2));
@@ -136,7 +136,7 @@ TEST_F(PatternTest, A_pattern_with_a_pattern_transformation)
 {
     raytracer::Sphere object;
     TestPattern pattern;
-    pattern.transform = raytracer::Matrix::scaling(2, 2, 2);
+    pattern.setTransform(raytracer::Matrix4::scaling(2, 2, 2));
     raytracer::Color c = pattern.patternAtShape(object, raytracer::Point(2, 3, 4));
     ASSERT_TRUE(c == raytracer::Color(1, 1.5, 2));
 }
@@ -145,9 +145,9 @@ TEST_F(PatternTest, A_pattern_with_a_pattern_transformation)
 TEST_F(PatternTest, A_pattern_with_both_an_object_and_a_pattern_transformation)
 {
     raytracer::Sphere object;
-    object.transform() = raytracer::Matrix::scaling(2, 2, 2);
+    object.setTransform(raytracer::Matrix4::scaling(2, 2, 2));
     TestPattern pattern;
-    pattern.transform = raytracer::Matrix::translation(0.5, 1, 1.5);
+    pattern.setTransform(raytracer::Matrix4::translation(0.5, 1, 1.5));
     raytracer::Color c = pattern.patternAtShape(object, raytracer::Point(2.5, 3, 3.5));
     ASSERT_TRUE(c == raytracer::Color(0.75, 0.5, 0.25));
 }
@@ -198,3 +198,102 @@ TEST_F(PatternTest, Checkers_should_repeat_in_z)
     ASSERT_TRUE(p.patternAt(raytracer::Point(0.00, 0.00, 0.99)) == white);
     ASSERT_TRUE(p.patternAt(raytracer::Point(0.00, 0.00, 1.01)) == black);
 }
+
+// A Perlin pattern blends its colors by noise
+TEST_F(PatternTest, A_Perlin_pattern_blends_its_colors_by_noise)
+{
+    raytracer::PerlinPattern p(white, black);
+    raytracer::Point point(1.25, -2.5, 3.75);
+    double n = raytracer::PerlinNoise::Noise(point);
+    ASSERT_TRUE(p.patternAt(raytracer::Point(0, 0, 0)) == white);
+    ASSERT_TRUE(p.patternAt(point) == white + (black - white) * n);
+}
+
+// A Perlin pattern with octaves blends by fractal noise
+TEST_F(PatternTest, A_Perlin_pattern_with_octaves_blends_by_fractal_noise)
+{
+    raytracer::PerlinPattern p(white, black, 4);
+    raytracer::Point point(1.25, -2.5, 3.7);
+    ASSERT_TRUE(p.patternAt(point) == white + (black - white) * raytracer::PerlinNoise::Fbm(point, 4));
+    p.turbulence = true;
+    p.gain = 0.6;
+    ASSERT_TRUE(p.patternAt(point) == white + (black - white) * raytracer::PerlinNoise::Turbulence(point, 4, 2, 0.6));
+}
+
+// A pattern on a grouped shape goes through the group transforms
+TEST_F(PatternTest, A_pattern_on_a_grouped_shape_goes_through_the_group_transforms)
+{
+    raytracer::Group outer;
+    outer.setTransform(raytracer::Matrix4::rotationY(M_PI / 2));
+    raytracer::Group *inner = new raytracer::Group();
+    inner->setTransform(raytracer::Matrix4::scaling(2, 2, 2));
+    outer.add(inner);
+    raytracer::Sphere *sphere = new raytracer::Sphere();
+    sphere->setTransform(raytracer::Matrix4::translation(5, 0, 0));
+    inner->add(sphere);
+
+    TestPattern pattern;
+    pattern.setTransform(raytracer::Matrix4::translation(0.5, 1, 1.5));
+    raytracer::Point world(1.7320, 1.1547, -5.5774);
+    raytracer::Point expected = (pattern.inverseTransform() * sphere->worldToObject(world)).asPoint();
+    raytracer::Color c = pattern.patternAtShape(*sphere, world);
+    ASSERT_TRUE(c == raytracer::Color(expected.x, expected.y, expected.z));
+    ASSERT_TRUE(c == raytracer::Color(-2.7113, -0.4226, -0.6340));
+}
+
+// A cached pattern lookup follows later transform changes
+TEST_F(PatternTest, A_cached_pattern_lookup_follows_later_transform_changes)
+{
+    raytracer::Group group;
+    raytracer::Sphere *sphere = new raytracer::Sphere();
+    group.add(sphere);
+    TestPattern pattern;
+    raytracer::Point world(2, 3, 4);
+    ASSERT_TRUE(pattern.patternAtShape(*sphere, world) == raytracer::Color(2, 3, 4));
+
+    pattern.setTransform(raytracer::Matrix4::scaling(2, 2, 2));
+    ASSERT_TRUE(pattern.patternAtShape(*sphere, world) == raytracer::Color(1, 1.5, 2));
+
+    sphere->setTransform(raytracer::Matrix4::translation(0, 1, 0));
+    ASSERT_TRUE(pattern.patternAtShape(*sphere, world) == raytracer::Color(1, 1, 2));
+
+    group.setTransform(raytracer::Matrix4::translation(2, 0, 0));
+    ASSERT_TRUE(pattern.patternAtShape(*sphere, world) == raytracer::Color(0, 1, 2));
+
+    raytracer::Group outer;
+    outer.setTransform(raytracer::Matrix4::scaling(0.5, 0.5, 0.5));
+    outer.add(new raytracer::Group());
+    ASSERT_TRUE(pattern.patternAtShape(*sphere, world) == raytracer::Color(0, 1, 2));
+
+    // Assignment brings another transform without moving the epoch.
+    raytracer::Sphere plain;
+    TestPattern scaled;
+    scaled.setTransform(raytracer::Matrix4::scaling(2, 2, 2));
+    ASSERT_TRUE(scaled.patternAtShape(plain, world) == raytracer::Color(1, 1.5, 2));
+    scaled = TestPattern();
+    ASSERT_TRUE(scaled.patternAtShape(plain, world) == raytracer::Color(2, 3, 4));
+}
+
+// Two patterns can share a shape and a shape can share a pattern
+TEST_F(PatternTest, Two_patterns_can_share_a_shape_and_a_shape_can_share_a_pattern)
+{
+    raytracer::Sphere small;
+    small.setTransform(raytracer::Matrix4::scaling(0.5, 0.5, 0.5));
+    raytracer::Sphere large;
+    large.setTransform(raytracer::Matrix4::scaling(2, 2, 2));
+
+    TestPattern plain;
+    TestPattern shifted;
+    shifted.setTransform(raytracer::Matrix4::translation(1, 1, 1));
+    raytracer::Point world(2, 3, 4);
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_TRUE(plain.patternAtShape(small, world) == raytracer::Color(4, 6, 8));
+        ASSERT_TRUE(shifted.patternAtShape(small, world) == raytracer::Color(3, 5, 7));
+        ASSERT_TRUE(plain.patternAtShape(large, world) == raytracer::Color(1, 1.5, 2));
+    }
+
+    raytracer::Sphere copy = large;
+    copy.setTransform(raytracer::Matrix4::identity());
+    ASSERT_TRUE(plain.patternAtShape(copy, world) == raytracer::Color(2, 3, 4));
+    ASSERT_TRUE(plain.patternAtShape(large, world) == raytracer::Color(1, 1.5, 2));
+}
@@ -0,0 +1,69 @@
+#include "raytracer.hpp"
+
+#include <gmock/gmock.h>
+
+class ProgressTest : public testing::Test {};
+
+// Progress from every thread slot is summed into one event
+TEST_F(ProgressTest, Progress_from_every_thread_slot_is_summed_into_one_event)
+{
+    raytracer::ProgressReporter progress(nullptr);
+    progress.start(100, 3);
+    progress.add(0, 10);
+    progress.add(2, 25);
+    progress.add(0, 5);
+    raytracer::ProgressEvent event = progress.snapshot();
+    EXPECT_EQ(event.done, 40);
+    EXPECT_EQ(event.total, 100);
+    EXPECT_DOUBLE_EQ(event.fraction(), 0.4);
+    EXPECT_FALSE(event.finished);
+}
+
+// A zero interval reports every batch
+TEST_F(ProgressTest, A_zero_interval_reports_every_batch)
+{
+    std::vector<std::size_t> reported;
+    raytracer::ProgressReporter progress([&](const raytracer::ProgressEvent &event) { reported.push_back(event.done); }, std::chrono::milliseconds(0));
+    progress.start(30, 1);
+    progress.add(0, 10);
+    progress.add(0, 10);
+    progress.add(0, 10);
+    EXPECT_EQ(reported, (std::vector<std::size_t>{10, 20, 30}));
+}
+
+// A long interval only sends the final event
+TEST_F(ProgressTest, A_long_interval_only_sends_the_final_event)
+{
+    std::vector<raytracer::ProgressEvent> events;
+    raytracer::ProgressReporter progress([&](const raytracer::ProgressEvent &event) { events.push_back(event); }, std::chrono::hours(1));
+    progress.start(64, 2);
+    for (int i = 0; i < 8; ++i)
+        progress.add(i % 2, 8);
+    progress.finish();
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_TRUE(events[0].finished);
+    EXPECT_EQ(events[0].done, 64);
+    EXPECT_EQ(events[0].remaining, 0);
+}
+
+// Rendering with a reporter ends on an event covering every pixel
+TEST_F(ProgressTest, Rendering_with_a_reporter_ends_on_an_event_covering_every_pixel)
+{
+    raytracer::World *w = raytracer::World::Default();
+    raytracer::Camera c(21, 13, M_PI / 2);
+    c.setTransform(raytracer::Matrix4::viewTransform(raytracer::Point(0, 0, -5), raytracer::Point(0, 0, 0), raytracer::Vector(0, 1, 0)));
+    std::vector<raytracer::ProgressEvent> events;
+    raytracer::ProgressReporter progress([&](const raytracer::ProgressEvent &event) { events.push_back(event); }, std::chrono::milliseconds(0));
+    raytracer::RenderOptions options;
+    // Many small tiles: RGBA32F is the format that leaves 4 pixels unrounded.
+    options.format = raytracer::PixelFormat::RGBA32F;
+    options.tileSize = 4;
+    options.threads = 2;
+    c.render(*w, options, &progress);
+    ASSERT_FALSE(events.empty());
+    EXPECT_TRUE(events.back().finished);
+    EXPECT_EQ(events.back().done, 21 * 13);
+    for (std::size_t i = 1; i < events.size(); ++i)
+        EXPECT_LE(events[i - 1].done, events[i].done);
+    delete w;
+}
@@ -30,7 +30,7 @@ TEST_F(RayTest, Computing_a_point_from_a_distance)
 TEST_F(RayTest, Translating_a_ray)
 {
     raytracer::Ray r(raytracer::Point(1, 2, 3), raytracer::Vector(0, 1, 0));
-    raytracer::Matrix m = raytracer::Matrix::translation(3, 4, 5);
+    raytracer::Matrix4 m = raytracer::Matrix4::translation(3, 4, 5);
     raytracer::Ray r2 = r.transform(m);
     EXPECT_TRUE(r2.origin() == raytracer::Point(4, 6, 8));
     EXPECT_TRUE(r2.direction() == raytracer::Vector(0, 1, 0));
@@ -40,7 +40,7 @@ TEST_F(RayTest, Translating_a_ray)
 TEST_F(RayTest, Scaling_a_ray)
 {
     raytracer::Ray r(raytracer::Point(1, 2, 3), raytracer::Vector(0, 1, 0));
-    raytracer::Matrix m = raytracer::Matrix::scaling(2, 3, 4);
+    raytracer::Matrix4 m = raytracer::Matrix4::scaling(2, 3, 4);
     raytracer::Ray r2 = r.transform(m);
     EXPECT_TRUE(r2.origin() == raytracer::Point(2, 6, 12));
     EXPECT_TRUE(r2.direction() == raytracer::Vector(0, 3, 0));
@@ -34,15 +34,27 @@ class ShapeTest : public testing::Test {};
 TEST_F(ShapeTest, The_default_transformation)
 {
     TestShape s;
-    ASSERT_TRUE(s.transform() == raytracer::Matrix::identity(4));
+    ASSERT_TRUE(s.transform() == raytracer::Matrix4::identity());
 }
 
 // Assigning a transformation
 TEST_F(ShapeTest, Assigning_a_transformation)
 {
     TestShape s;
-    s.transform() = raytracer::Matrix::translation(2, 3, 4);
-    ASSERT_TRUE(s.transform() == raytracer::Matrix::translation(2, 3, 4));
+    s.setTransform(raytracer::Matrix4::translation(2, 3, 4));
+    ASSERT_TRUE(s.transform() == raytracer::Matrix4::translation(2, 3, 4));
+}
+
+// Assigning a transformation updates the cached inverses
+TEST_F(ShapeTest, Assigning_a_transformation_updates_the_cached_inverses)
+{
+    TestShape s;
+    ASSERT_TRUE(s.inverseTransform() == raytracer::Matrix4::identity());
+    ASSERT_TRUE(s.transposedInverseTransform() == raytracer::Matrix4::identity());
+    auto t = raytracer::Matrix4::scaling(1, 0.5, 1) * raytracer::Matrix4::rotationZ(M_PI / 5);
+    s.setTransform(t);
+    ASSERT_TRUE(s.inverseTransform() == t.inverse());
+    ASSERT_TRUE(s.transposedInverseTransform() == t.inverse().transpose());
 }
 
 // The default material
@@ -65,7 +77,7 @@ TEST_F(ShapeTest, Intersecting_a_scaled_shape_with_a_ray)
 {
     raytracer::Ray r(raytracer::Point(0, 0, -5), raytracer::Vector(0, 0, 1));
     TestShape s;
-    s.transform() = raytracer::Matrix::scaling(2, 2, 2);
+    s.setTransform(raytracer::Matrix4::scaling(2, 2, 2));
     auto xs = s.intersect(r);
     ASSERT_TRUE(s.savedRay.origin() == raytracer::Point(0, 0, -2.5));
     ASSERT_TRUE(s.savedRay.direction() == raytracer::Vector(0, 0, 0.5));
@@ -76,7 +88,7 @@ TEST_F(ShapeTest, Intersecting_a_translated_shape_with_a_ray)
 {
     raytracer::Ray r(raytracer::Point(0, 0, -5), raytracer::Vector(0, 0, 1));
     TestShape s;
-    s.transform() = raytracer::Matrix::translation(5, 0, 0);
+    s.setTransform(raytracer::Matrix4::translation(5, 0, 0));
     auto xs = s.intersect(r);
     ASSERT_TRUE(s.savedRay.origin() == raytracer::Point(-5, 0, -5));
     ASSERT_TRUE(s.savedRay.direction() == raytracer::Vector(0, 0, 1));
@@ -86,7 +98,7 @@ TEST_F(ShapeTest, Intersecting_a_translated_shape_with_a_ray)
 TEST_F(ShapeTest, Computing_the_normal_on_a_translated_shape)
 {
     TestShape s;
-    s.transform() = raytracer::Matrix::translation(0, 1, 0);
+    s.setTransform(raytracer::Matrix4::translation(0, 1, 0));
     auto n = s.normalAt(raytracer::Point(0, 1.70711, -0.70711));
     ASSERT_TRUE(n == raytracer::Vector(0, 0.70711, -0.70711));
 }
@@ -95,7 +107,7 @@ TEST_F(ShapeTest, Computing_the_normal_on_a_translated_shape)
 TEST_F(ShapeTest, Computing_the_normal_on_a_transformed_shape)
 {
     TestShape s;
-    s.transform() = raytracer::Matrix::scaling(1, 0.5, 1) * raytracer::Matrix::rotationZ(M_PI / 5);
+    s.setTransform(raytracer::Matrix4::scaling(1, 0.5, 1) * raytracer::Matrix4::rotationZ(M_PI / 5));
     auto n = s.normalAt(raytracer::Point(0, sqrt(2) / 2, -sqrt(2) / 2));
     ASSERT_TRUE(n == raytracer::Vector(0, 0.97014, -0.24254));
 }
@@ -111,12 +123,12 @@ TEST_F(ShapeTest, A_shape_has_a_parent_attribute)
 TEST_F(ShapeTest, Converting_a_point_from_world_to_object_space)
 {
     raytracer::Group g1;
-    g1.transform() = raytracer::Matrix::rotationY(M_PI / 2);
+    g1.setTransform(raytracer::Matrix4::rotationY(M_PI / 2));
     raytracer::Group *g2 = new raytracer::Group();
-    g2->transform() = raytracer::Matrix::scaling(2, 2, 2);
+    g2->setTransform(raytracer::Matrix4::scaling(2, 2, 2));
     g1.add(g2);
     raytracer::Sphere *s = new raytracer::Sphere();
-    s->transform() = raytracer::Matrix::translation(5, 0, 0);
+    s->setTransform(raytracer::Matrix4::translation(5, 0, 0));
     g2->add(s);
     auto p = s->worldToObject(raytracer::Point(-2, 0, -10));
     ASSERT_TRUE(p == raytracer::Point(0, 0, -1));
@@ -126,12 +138,12 @@ TEST_F(ShapeTest, Converting_a_point_from_world_to_object_space)
 TEST_F(ShapeTest, Converting_a_normal_from_object_to_world_space)
 {
     raytracer::Group g1;
-    g1.transform() = raytracer::Matrix::rotationY(M_PI / 2);
+    g1.setTransform(raytracer::Matrix4::rotationY(M_PI / 2));
     raytracer::Group *g2 = new raytracer::Group();
-    g2->transform() = raytracer::Matrix::scaling(1, 2, 3);
+    g2->setTransform(raytracer::Matrix4::scaling(1, 2, 3));
     g1.add(g2);
     raytracer::Sphere *s = new raytracer::Sphere();
-    s->transform() = raytracer::Matrix::translation(5, 0, 0);
+    s->setTransform(raytracer::Matrix4::translation(5, 0, 0));
     g2->add(s);
     auto n = s->normalToWorld(raytracer::Vector(sqrt(3) / 3, sqrt(3) / 3, sqrt(3) / 3));
     ASSERT_TRUE(n == raytracer::Vector(0.2857, 0.4286, -0.8571));
@@ -141,13 +153,45 @@ TEST_F(ShapeTest, Converting_a_normal_from_object_to_world_space)
 TEST_F(ShapeTest, Finding_the_normal_on_a_child_object)
 {
     raytracer::Group g1;
-    g1.transform() = raytracer::Matrix::rotationY(M_PI / 2);
+    g1.setTransform(raytracer::Matrix4::rotationY(M_PI / 2));
     raytracer::Group *g2 = new raytracer::Group();
-    g2->transform() = raytracer::Matrix::scaling(1, 2, 3);
+    g2->setTransform(raytracer::Matrix4::scaling(1, 2, 3));
     g1.add(g2);
     raytracer::Sphere *s = new raytracer::Sphere();
-    s->transform() = raytracer::Matrix::translation(5, 0, 0);
+    s->setTransform(raytracer::Matrix4::translation(5, 0, 0));
     g2->add(s);
     auto n = s->normalAt(raytracer::Point(1.7321, 1.1547, -5.5774));
     ASSERT_TRUE(n == raytracer::Vector(0.2857, 0.4286, -0.8571));
 }
+
+// Transforming bounds matches transforming their corners
+TEST_F(ShapeTest, Transforming_bounds_matches_transforming_their_corners)
+{
+    raytracer::Bounds box(raytracer::Point(-1, -2, 0.5), raytracer::Point(3, 1, 2));
+    raytracer::Matrix4 m = raytracer::Matrix4::translation(1, -2, 3) * raytracer::Matrix4::rotationX(0.3) * raytracer::Matrix4::rotationY(-1.1) * raytracer::Matrix4::scaling(2, 0.5, -1);
+
+    raytracer::Bounds expected = raytracer::Bounds::Empty();
+    for (int corner = 0; corner < 8; ++corner) {
+        raytracer::Point p(corner & 1 ? box.max.x : box.min.x, corner & 2 ? box.max.y : box.min.y, corner & 4 ? box.max.z : box.min.z);
+        expected += (m * p).asPoint();
+    }
+    raytracer::Bounds b = box.transform(m);
+    for (int axis = 0; axis < 3; ++axis) {
+        EXPECT_NEAR(b.min[axis], expected.min[axis], 1e-12);
+        EXPECT_NEAR(b.max[axis], expected.max[axis], 1e-12);
+    }
+
+    EXPECT_TRUE(raytracer::Bounds::Empty().transform(m).empty());
+}
+
+// Transforming an unbounded box keeps the axes the transform leaves alone
+TEST_F(ShapeTest, Transforming_an_unbounded_box_keeps_the_axes_the_transform_leaves_alone)
+{
+    raytracer::Plane plane;
+    plane.setTransform(raytracer::Matrix4::translation(0, 2, 0) * raytracer::Matrix4::scaling(3, 1, 3));
+    raytracer::Bounds b = plane.parentSpaceBounds();
+    EXPECT_EQ(b.min.y, 2);
+    EXPECT_EQ(b.max.y, 2);
+    EXPECT_TRUE(std::isinf(b.min.x) && b.min.x < 0);
+    EXPECT_TRUE(std::isinf(b.max.z) && b.max.z > 0);
+}
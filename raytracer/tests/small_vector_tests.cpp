@@ -0,0 +1,74 @@
+#include "raytracer.hpp"
+
+#include "allocation_counter.hpp"
+
+#include <gmock/gmock.h>
+
+class SmallVectorTest : public testing::Test {};
+
+// A small vector keeps its first elements inline
+TEST_F(SmallVectorTest, A_small_vector_keeps_its_first_elements_inline)
+{
+    AllocationCounter allocations;
+    raytracer::SmallVector<int, 4> v;
+    for (int i = 0; i < 4; ++i)
+        v.push_back(i);
+    ASSERT_EQ(v.size(), 4);
+    ASSERT_TRUE(v.isInline());
+    ASSERT_EQ(allocations.count(), 0);
+    for (int i = 0; i < 4; ++i)
+        ASSERT_EQ(v[i], i);
+}
+
+// A small vector spills to the heap past its inline capacity
+TEST_F(SmallVectorTest, A_small_vector_spills_to_the_heap_past_its_inline_capacity)
+{
+    AllocationCounter allocations;
+    raytracer::SmallVector<int, 4> v;
+    for (int i = 0; i < 100; ++i)
+        v.push_back(i);
+    ASSERT_EQ(v.size(), 100);
+    ASSERT_FALSE(v.isInline());
+    ASSERT_GT(allocations.count(), 0);
+    for (int i = 0; i < 100; ++i)
+        ASSERT_EQ(v[i], i);
+}
+
+// Copying and moving a small vector keeps its elements
+TEST_F(SmallVectorTest, Copying_and_moving_a_small_vector_keeps_its_elements)
+{
+    raytracer::SmallVector<int, 2> small{1, 2};
+    raytracer::SmallVector<int, 2> large{1, 2, 3, 4, 5};
+
+    auto smallCopy = small;
+    auto largeCopy = large;
+    ASSERT_EQ(smallCopy.size(), 2);
+    ASSERT_EQ(largeCopy.size(), 5);
+    ASSERT_EQ(largeCopy[4], 5);
+
+    auto smallMoved = std::move(smallCopy);
+    auto largeMoved = std::move(largeCopy);
+    ASSERT_EQ(smallMoved.size(), 2);
+    ASSERT_EQ(smallMoved[1], 2);
+    ASSERT_EQ(largeMoved.size(), 5);
+    ASSERT_EQ(largeMoved[4], 5);
+    ASSERT_TRUE(smallCopy.empty());
+    ASSERT_TRUE(largeCopy.empty());
+    ASSERT_TRUE(largeCopy.isInline());
+}
+
+// Inserting into and erasing from a small vector
+TEST_F(SmallVectorTest, Inserting_into_and_erasing_from_a_small_vector)
+{
+    raytracer::SmallVector<int, 3> v{1, 3, 4};
+    v.insert(v.begin() + 1, 2);
+    ASSERT_EQ(v.size(), 4);
+    for (int i = 0; i < 4; ++i)
+        ASSERT_EQ(v[i], i + 1);
+
+    v.erase(v.begin());
+    v.erase(v.end() - 1);
+    ASSERT_EQ(v.size(), 2);
+    ASSERT_EQ(v[0], 2);
+    ASSERT_EQ(v[1], 3);
+}
@@ -72,15 +72,15 @@ TEST_F(SphereTest, Intersect_sets_the_object_on_the_intersection)
 TEST_F(SphereTest, A_spheres_default_transformation)
 {
     raytracer::Sphere s;
-    EXPECT_EQ(s.transform(), raytracer::Matrix::identity(4));
+    EXPECT_EQ(s.transform(), raytracer::Matrix4::identity());
 }
 
 // Changing a sphere's transformation
 TEST_F(SphereTest, Changing_a_spheres_transformation)
 {
     raytracer::Sphere s;
-    raytracer::Matrix t = raytracer::Matrix::translation(2, 3, 4);
-    s.transform() = t;
+    raytracer::Matrix4 t = raytracer::Matrix4::translation(2, 3, 4);
+    s.setTransform(t);
     EXPECT_TRUE(s.transform() == t);
 }
 
@@ -89,7 +89,7 @@ TEST_F(SphereTest, Intersecting_a_scaled_sphere_with_a_ray)
 {
     raytracer::Ray r(raytracer::Point(0, 0, -5), raytracer::Vector(0, 0, 1));
     raytracer::Sphere s;
-    s.transform() = raytracer::Matrix::scaling(2, 2, 2);
+    s.setTransform(raytracer::Matrix4::scaling(2, 2, 2));
     raytracer::Intersections xs = s.intersect(r);
     EXPECT_EQ(xs.count(), 2);
     EXPECT_TRUE(double_equals(xs[0].t(), 3));
@@ -101,7 +101,7 @@ TEST_F(SphereTest, Intersecting_a_translated_sphere_with_a_ray)
 {
     raytracer::Ray r(raytracer::Point(0, 0, -5), raytracer::Vector(0, 0, 1));
     raytracer::Sphere s;
-    s.transform() = raytracer::Matrix::translation(5, 0, 0);
+    s.setTransform(raytracer::Matrix4::translation(5, 0, 0));
     raytracer::Intersections xs = s.intersect(r);
     EXPECT_EQ(xs.count(), 0);
 }
@@ -150,7 +150,7 @@ TEST_F(SphereTest, The_normal_is_a_normalized_vector)
 TEST_F(SphereTest, Computing_the_normal_on_a_translated_sphere)
 {
     raytracer::Sphere s;
-    s.transform() = raytracer::Matrix::translation(0, 1, 0);
+    s.setTransform(raytracer::Matrix4::translation(0, 1, 0));
     raytracer::Tuple n = s.normalAt(raytracer::Point(0, 1.70711, -0.70711));
     EXPECT_TRUE(n == raytracer::Vector(0, 0.70711, -0.70711));
 }
@@ -159,7 +159,7 @@ TEST_F(SphereTest, Computing_the_normal_on_a_translated_sphere)
 TEST_F(SphereTest, Computing_the_normal_on_a_transformed_sphere)
 {
     raytracer::Sphere s;
-    s.transform() = raytracer::Matrix::scaling(1, 0.5, 1) * raytracer::Matrix::rotationZ(M_PI / 5);
+    s.setTransform(raytracer::Matrix4::scaling(1, 0.5, 1) * raytracer::Matrix4::rotationZ(M_PI / 5));
     raytracer::Tuple n = s.normalAt(raytracer::Point(0, sqrt(2) / 2, -sqrt(2) / 2));
     EXPECT_TRUE(n == raytracer::Vector(0, 0.97014, -0.24254));
 }
@@ -186,7 +186,7 @@ TEST_F(SphereTest, A_sphere_may_be_assigned_a_material)
 TEST_F(SphereTest, A_helper_for_producing_a_sphere_with_a_glassy_material)
 {
     raytracer::GlassSphere s;
-    EXPECT_TRUE(s.transform() == raytracer::Matrix::identity(4));
+    EXPECT_TRUE(s.transform() == raytracer::Matrix4::identity());
     EXPECT_TRUE(s.material().transparency == 1.0);
     EXPECT_TRUE(s.material().refractiveIndex == 1.5);
 }
@@ -0,0 +1,72 @@
+#include "raytracer.hpp"
+
+#include <gmock/gmock.h>
+
+class TileSchedulerTest : public testing::Test {};
+
+static std::vector<int> coverage(raytracer::TileScheduler &scheduler, int width, int height)
+{
+    std::vector<int> covered(width * height, 0);
+    raytracer::Tile tile;
+    while (scheduler.next(tile))
+        for (int y = tile.y0; y < tile.y1; ++y)
+            for (int x = tile.x0; x < tile.x1; ++x)
+                covered[y * width + x]++;
+    return covered;
+}
+
+// Every order covers each pixel exactly once
+TEST_F(TileSchedulerTest, Every_order_covers_each_pixel_exactly_once)
+{
+    for (auto order : {raytracer::TileOrder::Scanline, raytracer::TileOrder::Hilbert, raytracer::TileOrder::Spiral}) {
+        raytracer::TileScheduler scheduler(37, 21, 8, order);
+        ASSERT_EQ(scheduler.count(), 5 * 3);
+        for (int n : coverage(scheduler, 37, 21))
+            ASSERT_EQ(n, 1);
+    }
+}
+
+// Tiles on the right and bottom edges are clipped to the image
+TEST_F(TileSchedulerTest, Tiles_on_the_right_and_bottom_edges_are_clipped_to_the_image)
+{
+    raytracer::TileScheduler scheduler(10, 6, 4, raytracer::TileOrder::Scanline);
+    auto &tiles = scheduler.tiles();
+    ASSERT_EQ(tiles.size(), 6);
+    EXPECT_EQ(tiles[2].x0, 8);
+    EXPECT_EQ(tiles[2].width(), 2);
+    EXPECT_EQ(tiles[5].height(), 2);
+    EXPECT_EQ(tiles[5].pixels(), 4);
+}
+
+// Consecutive Hilbert tiles share an edge
+TEST_F(TileSchedulerTest, Consecutive_Hilbert_tiles_share_an_edge)
+{
+    raytracer::TileScheduler scheduler(64, 64, 8, raytracer::TileOrder::Hilbert);
+    auto &tiles = scheduler.tiles();
+    ASSERT_EQ(tiles.size(), 64);
+    for (std::size_t i = 1; i < tiles.size(); ++i)
+        ASSERT_EQ(std::abs(tiles[i].x0 - tiles[i - 1].x0) + std::abs(tiles[i].y0 - tiles[i - 1].y0), 8);
+}
+
+// A spiral starts from the center tile
+TEST_F(TileSchedulerTest, A_spiral_starts_from_the_center_tile)
+{
+    raytracer::TileScheduler scheduler(50, 30, 10, raytracer::TileOrder::Spiral);
+    auto &tiles = scheduler.tiles();
+    EXPECT_EQ(tiles[0].x0, 20);
+    EXPECT_EQ(tiles[0].y0, 10);
+}
+
+// Each tile is handed out once until the scheduler is reset
+TEST_F(TileSchedulerTest, Each_tile_is_handed_out_once_until_the_scheduler_is_reset)
+{
+    raytracer::TileScheduler scheduler(16, 16, 8);
+    raytracer::Tile tile;
+    int claimed = 0;
+    while (scheduler.next(tile))
+        claimed++;
+    EXPECT_EQ(claimed, 4);
+    EXPECT_FALSE(scheduler.next(tile));
+    scheduler.reset();
+    EXPECT_TRUE(scheduler.next(tile));
+}
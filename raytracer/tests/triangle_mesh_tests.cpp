@@ -0,0 +1,146 @@
+#include "raytracer.hpp"
+
+#include <gmock/gmock.h>
+
+class TriangleMeshTest : public ::testing::Test {};
+
+// Rays from a camera looking at the teapot, many of them grazing it.
+static std::vector<raytracer::Ray> teapotRays(int size)
+{
+    raytracer::Camera camera(size, size, M_PI / 3);
+    camera.setTransform(raytracer::Matrix4::viewTransform(raytracer::Point(0, 3.0, -5.0), raytracer::Point(0, 0, 0), raytracer::Vector(0, 1, 0)));
+    std::vector<raytracer::Ray> rays;
+    for (int y = 0; y < size; ++y)
+        for (int x = 0; x < size; ++x)
+            rays.push_back(camera.rayForPixel(x, y));
+    return rays;
+}
+
+// A mesh stores the triangles of its mesh data
+TEST_F(TriangleMeshTest, A_mesh_stores_the_triangles_of_its_mesh_data)
+{
+    raytracer::TriangleMesh mesh(raytracer::OBJLoader::Parse("v 0 1 0\nv -1 0 0\nv 1 0 0\nv 0 0 1\nf 1 2 3\nf 1 3 4\n"));
+    EXPECT_EQ(mesh.size(), 2);
+    EXPECT_TRUE(mesh.vertex(1, 2) == raytracer::Point(0, 0, 1));
+    EXPECT_TRUE(mesh.bounds().min == raytracer::Point(-1, 0, 0));
+    EXPECT_TRUE(mesh.bounds().max == raytracer::Point(1, 1, 1));
+}
+
+// A ray hitting a mesh reports the triangle it hit
+TEST_F(TriangleMeshTest, A_ray_hitting_a_mesh_reports_the_triangle_it_hit)
+{
+    raytracer::TriangleMesh mesh(raytracer::OBJLoader::Parse("v 0 1 0\nv -1 0 0\nv 1 0 0\nv 10 1 0\nv 9 0 0\nv 11 0 0\nf 1 2 3\nf 4 5 6\n"));
+    raytracer::Ray r(raytracer::Point(10, 0.5, -2), raytracer::Vector(0, 0, 1));
+    raytracer::Intersections xs = mesh.intersect(r);
+    ASSERT_EQ(xs.count(), 1);
+    EXPECT_DOUBLE_EQ(xs[0].t(), 2);
+    EXPECT_EQ(xs[0].primitive(), 1);
+    EXPECT_TRUE(mesh.normalAt(r.position(2), xs[0]) == raytracer::Vector(0, 0, -1));
+}
+
+// A mesh finds the same hits as a BVH of triangles
+TEST_F(TriangleMeshTest, A_mesh_finds_the_same_hits_as_a_BVH_of_triangles)
+{
+    raytracer::MeshData data = raytracer::OBJLoader::LoadFile(RAYTRACER_TEAPOT_OBJ);
+    raytracer::OBJFileParser parser = raytracer::OBJFileParser::FromMesh(data);
+    std::vector<raytracer::Shape *> triangles;
+    for (auto &face : parser.faces)
+        triangles.push_back(new raytracer::Triangle(face));
+    raytracer::BVH bvh(triangles);
+    raytracer::TriangleMesh mesh(data);
+
+    int hits = 0;
+    for (const raytracer::Ray &r : teapotRays(48)) {
+        auto expected = bvh.closestHit(r, 0, std::numeric_limits<double>::infinity());
+        auto actual = mesh.closestHit(r, 0, std::numeric_limits<double>::infinity());
+        ASSERT_EQ(actual.has_value(), expected.has_value());
+        ASSERT_EQ(mesh.occluded(r, 100), bvh.occluded(r, 100));
+        if (!expected)
+            continue;
+        ++hits;
+        ASSERT_NEAR(actual->t(), expected->t(), 1e-9);
+        raytracer::Point p = r.position(expected->t()).asPoint();
+        ASSERT_TRUE(mesh.normalAt(p, *actual) == expected->shape().normalAt(p, *expected));
+
+        raytracer::Intersections xs = mesh.intersect(r);
+        ASSERT_TRUE(xs.hit() != nullptr);
+        ASSERT_NEAR(xs.hit()->t(), expected->t(), 1e-9);
+    }
+    EXPECT_GT(hits, 100);
+}
+
+// Copies of a mesh share its geometry
+TEST_F(TriangleMeshTest, Copies_of_a_mesh_share_its_geometry)
+{
+    raytracer::TriangleMesh mesh(raytracer::OBJLoader::Parse("v 0 1 0\nv -1 0 0\nv 1 0 0\nf 1 2 3\n"));
+    raytracer::TriangleMesh copy = mesh;
+    copy.setTransform(raytracer::Matrix4::translation(0, 0, 5));
+    EXPECT_EQ(&copy.mesh(), &mesh.mesh());
+    EXPECT_EQ(&copy.tree(), &mesh.tree());
+
+    raytracer::Ray r(raytracer::Point(0, 0.5, -2), raytracer::Vector(0, 0, 1));
+    EXPECT_EQ(mesh.intersect(r)[0].t(), 2);
+    EXPECT_EQ(copy.intersect(r)[0].t(), 7);
+}
+
+// A mesh in a world shades like its triangles
+TEST_F(TriangleMeshTest, A_mesh_in_a_world_shades_like_its_triangles)
+{
+    raytracer::MeshData data = raytracer::OBJLoader::LoadFile(RAYTRACER_TEAPOT_OBJ);
+    raytracer::World meshWorld, triangleWorld;
+    for (raytracer::World *world : {&meshWorld, &triangleWorld})
+        world->light() = new raytracer::PointLight(raytracer::Point(-10, 10, -10), raytracer::Color(1, 1, 1));
+
+    meshWorld.shapes().push_back(new raytracer::TriangleMesh(data));
+    std::vector<raytracer::Shape *> triangles;
+    for (auto &face : raytracer::OBJFileParser::FromMesh(data).faces)
+        triangles.push_back(new raytracer::Triangle(face));
+    triangleWorld.shapes().push_back(new raytracer::BVH(triangles));
+
+    for (const raytracer::Ray &r : teapotRays(16))
+        ASSERT_TRUE(meshWorld.colorAt(r) == triangleWorld.colorAt(r));
+}
+
+// A mesh with vertex normals shades like smooth triangles
+TEST_F(TriangleMeshTest, A_mesh_with_vertex_normals_shades_like_smooth_triangles)
+{
+    // A coarse open-ended sphere: normals point away from the center, flat
+    // facets do not. The poles are left out to avoid degenerate triangles.
+    std::stringstream content;
+    const int rings = 6, segments = 8;
+    for (int i = 0; i <= rings; i++) {
+        for (int j = 0; j < segments; j++) {
+            double theta = 0.3 + (M_PI - 0.6) * i / rings, phi = 2 * M_PI * j / segments;
+            double x = std::sin(theta) * std::cos(phi), y = std::cos(theta), z = std::sin(theta) * std::sin(phi);
+            content << "v " << x << " " << y << " " << z << "\nvn " << x << " " << y << " " << z << "\n";
+        }
+    }
+    for (int i = 0; i < rings; i++) {
+        for (int j = 0; j < segments; j++) {
+            int a = i * segments + j + 1, b = i * segments + (j + 1) % segments + 1;
+            int c = a + segments, d = b + segments;
+            content << "f " << a << "//" << a << " " << c << "//" << c << " " << d << "//" << d << " " << b << "//" << b << "\n";
+        }
+    }
+
+    raytracer::MeshData data = raytracer::OBJLoader::Parse(content.str());
+    raytracer::TriangleMesh mesh(data);
+    raytracer::OBJFileParser parser = raytracer::OBJFileParser::FromMesh(data);
+    ASSERT_EQ(parser.smoothFaces.size(), parser.faces.size());
+
+    int hits = 0;
+    for (int k = 0; k < 50; k++) {
+        raytracer::Ray r(raytracer::Point(-0.9 + k * 0.036, 0.3, -5), raytracer::Vector(0, 0, 1));
+        auto hit = mesh.closestHit(r, 0, std::numeric_limits<double>::infinity());
+        if (!hit)
+            continue;
+        ++hits;
+        raytracer::Point p = r.position(hit->t()).asPoint();
+        const raytracer::SmoothTriangle &tri = parser.smoothFaces[parser.smoothIndices[hit->primitive()]];
+        auto expected = tri.closestHit(r, 0, std::numeric_limits<double>::infinity());
+        ASSERT_TRUE(expected.has_value());
+        ASSERT_TRUE(mesh.normalAt(p, *hit) == tri.normalAt(p, *expected));
+        ASSERT_FALSE(mesh.normalAt(p, *hit) == mesh.normalToWorld(mesh.faceNormal(hit->primitive())));
+    }
+    EXPECT_GT(hits, 40);
+}
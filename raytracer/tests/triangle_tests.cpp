@@ -69,3 +69,56 @@ TEST_F(TriangleTest, ARayStrikesATriangle)
     ASSERT_TRUE(xs.count() == 1);
     ASSERT_TRUE(double_equals(xs[0].t(), 2));
 }
+
+static raytracer::SmoothTriangle smoothTriangle()
+{
+    return raytracer::SmoothTriangle(raytracer::Point(0, 1, 0), raytracer::Point(-1, 0, 0), raytracer::Point(1, 0, 0),
+                                     raytracer::Vector(0, 1, 0), raytracer::Vector(-1, 0, 0), raytracer::Vector(1, 0, 0));
+}
+
+// Constructing a smooth triangle
+TEST_F(TriangleTest, ConstructingASmoothTriangle)
+{
+    raytracer::SmoothTriangle tri = smoothTriangle();
+    ASSERT_TRUE(tri.p1 == raytracer::Point(0, 1, 0));
+    ASSERT_TRUE(tri.p2 == raytracer::Point(-1, 0, 0));
+    ASSERT_TRUE(tri.p3 == raytracer::Point(1, 0, 0));
+    ASSERT_TRUE(tri.n1 == raytracer::Vector(0, 1, 0));
+    ASSERT_TRUE(tri.n2 == raytracer::Vector(-1, 0, 0));
+    ASSERT_TRUE(tri.n3 == raytracer::Vector(1, 0, 0));
+}
+
+// An intersection with a smooth triangle stores u/v
+TEST_F(TriangleTest, AnIntersectionWithASmoothTriangleStoresUV)
+{
+    raytracer::SmoothTriangle tri = smoothTriangle();
+    raytracer::Ray ray(raytracer::Point(-0.2, 0.3, -2), raytracer::Vector(0, 0, 1));
+    auto xs = tri.intersect(ray);
+    ASSERT_TRUE(xs.count() == 1);
+    ASSERT_NEAR(xs[0].u(), 0.45, EPSILON);
+    ASSERT_NEAR(xs[0].v(), 0.25, EPSILON);
+
+    auto hit = tri.closestHit(ray, 0, 10);
+    ASSERT_TRUE(hit.has_value());
+    ASSERT_NEAR(hit->u(), 0.45, EPSILON);
+    ASSERT_NEAR(hit->v(), 0.25, EPSILON);
+}
+
+// A smooth triangle uses u/v to interpolate the normal
+TEST_F(TriangleTest, ASmoothTriangleUsesUVToInterpolateTheNormal)
+{
+    raytracer::SmoothTriangle tri = smoothTriangle();
+    raytracer::Intersection i(1, tri, 0.45, 0.25);
+    ASSERT_TRUE(tri.normalAt(raytracer::Point(0, 0, 0), i) == raytracer::Vector(-0.5547, 0.83205, 0));
+}
+
+// Preparing the normal on a smooth triangle
+TEST_F(TriangleTest, PreparingTheNormalOnASmoothTriangle)
+{
+    raytracer::SmoothTriangle tri = smoothTriangle();
+    raytracer::Intersection i(1, tri, 0.45, 0.25);
+    raytracer::Ray ray(raytracer::Point(-0.2, 0.3, -2), raytracer::Vector(0, 0, 1));
+    raytracer::Intersections xs({i});
+    auto comps = i.prepareComputations(ray, xs);
+    ASSERT_TRUE(comps.normalv == raytracer::Vector(-0.5547, 0.83205, 0));
+}
@@ -1,5 +1,7 @@
 #include "raytracer.hpp"
 
+#include "allocation_counter.hpp"
+
 #include <gmock/gmock.h>
 
 class WorldTest : public testing::Test {};
@@ -23,7 +25,7 @@ TEST_F(WorldTest, The_default_world)
     s1.material().specular() = 0.2;
 
     raytracer::Sphere s2;
-    s2.transform() = raytracer::Matrix::scaling(0.5, 0.5, 0.5);
+    s2.setTransform(raytracer::Matrix4::scaling(0.5, 0.5, 0.5));
 
     raytracer::World *w = raytracer::World::Default();
 
@@ -63,6 +65,28 @@ TEST_F(WorldTest, Intersect_a_world_with_a_ray)
     delete w;
 }
 
+// The closest hit of a world within a ray interval
+TEST_F(WorldTest, The_closest_hit_of_a_world_within_a_ray_interval)
+{
+    raytracer::World *w = raytracer::World::Default();
+    raytracer::Ray r(raytracer::Point(0, 0, -5), raytracer::Vector(0, 0, 1));
+    double inf = std::numeric_limits<double>::infinity();
+
+    auto hit = w->closestHit(r, 0, inf);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->t(), 4);
+    EXPECT_EQ(&hit->shape(), w->shapes()[0]);
+
+    hit = w->closestHit(r, 4.1, inf);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->t(), 4.5);
+    EXPECT_EQ(&hit->shape(), w->shapes()[1]);
+
+    EXPECT_FALSE(w->closestHit(r, 0, 4).has_value());
+    EXPECT_FALSE(w->closestHit(r, 6.1, inf).has_value());
+    delete w;
+}
+
 // Shading an intersection
 TEST_F(WorldTest, Shading_an_intersection)
 {
@@ -167,7 +191,7 @@ TEST_F(WorldTest, ShadeHit_is_given_an_intersection_in_shadow)
     w.light() = new raytracer::PointLight(raytracer::Point(0, 0, -10), raytracer::Color(1, 1, 1));
     raytracer::Sphere *s1 = new raytracer::Sphere();
     raytracer::Sphere *s2 = new raytracer::Sphere();
-    s2->transform() = raytracer::Matrix::translation(0, 0, 10);
+    s2->setTransform(raytracer::Matrix4::translation(0, 0, 10));
     w.shapes().push_back(s1);
     w.shapes().push_back(s2);
     raytracer::Ray r(raytracer::Point(0, 0, 5), raytracer::Vector(0, 0, 1));
@@ -197,7 +221,7 @@ TEST_F(WorldTest, The_reflected_color_for_a_reflective_material)
     raytracer::World *w = raytracer::World::Default();
     raytracer::Plane *p = new raytracer::Plane();
     p->material().reflective = 0.5;
-    p->transform() = raytracer::Matrix::translation(0, -1, 0);
+    p->setTransform(raytracer::Matrix4::translation(0, -1, 0));
     w->shapes().push_back(p);
     raytracer::Ray r(raytracer::Point(0, 0, -3), raytracer::Vector(0, -sqrt(2) / 2, sqrt(2) / 2));
     raytracer::Intersection i(sqrt(2), *p);
@@ -214,7 +238,7 @@ TEST_F(WorldTest, shadeHit_is_given_an_intersection_in_shadow)
     w.light() = new raytracer::PointLight(raytracer::Point(0, 0, -10), raytracer::Color(1, 1, 1));
     raytracer::Sphere *s1 = new raytracer::Sphere();
     raytracer::Sphere *s2 = new raytracer::Sphere();
-    s2->transform() = raytracer::Matrix::translation(0, 0, 10);
+    s2->setTransform(raytracer::Matrix4::translation(0, 0, 10));
     w.shapes().push_back(s1);
     w.shapes().push_back(s2);
     raytracer::Ray r(raytracer::Point(0, 0, 5), raytracer::Vector(0, 0, 1));
@@ -232,12 +256,12 @@ TEST_F(WorldTest, colorAt_with_mutually_reflective_surfaces)
 
     raytracer::Plane *lower = new raytracer::Plane();
     lower->material().reflective = 1;
-    lower->transform() = raytracer::Matrix::translation(0, -1, 0);
+    lower->setTransform(raytracer::Matrix4::translation(0, -1, 0));
     w.shapes().push_back(lower);
 
     raytracer::Plane *upper = new raytracer::Plane();
     upper->material().reflective = 1;
-    upper->transform() = raytracer::Matrix::translation(0, 1, 0);
+    upper->setTransform(raytracer::Matrix4::translation(0, 1, 0));
     w.shapes().push_back(upper);
 
     raytracer::Ray r(raytracer::Point(0, 0, 0), raytracer::Vector(0, 1, 0));
@@ -251,7 +275,7 @@ TEST_F(WorldTest, the_reflected_color_at_the_maximum_recursive_depth)
 
     raytracer::Plane *p = new raytracer::Plane();
     p->material().reflective = 0.5;
-    p->transform() = raytracer::Matrix::translation(0, -1, 0);
+    p->setTransform(raytracer::Matrix4::translation(0, -1, 0));
     w->shapes().push_back(p);
 
     raytracer::Ray r(raytracer::Point(0, 0, -3), raytracer::Vector(0, -sqrt(2) / 2, sqrt(2) / 2));
@@ -353,7 +377,7 @@ TEST_F(WorldTest, ShadeHit_with_a_transparent_material)
     raytracer::World *w = raytracer::World::Default();
 
     raytracer::Plane *floor = new raytracer::Plane();
-    floor->transform() = raytracer::Matrix::translation(0, -1, 0);
+    floor->setTransform(raytracer::Matrix4::translation(0, -1, 0));
     floor->material().transparency = 0.5;
     floor->material().refractiveIndex = 1.5;
     w->shapes().push_back(floor);
@@ -361,7 +385,7 @@ TEST_F(WorldTest, ShadeHit_with_a_transparent_material)
     raytracer::Sphere *ball = new raytracer::Sphere();
     ball->material().color() = raytracer::Color(1, 0, 0);
     ball->material().ambient() = 0.5;
-    ball->transform() = raytracer::Matrix::translation(0, -3.5, -0.5);
+    ball->setTransform(raytracer::Matrix4::translation(0, -3.5, -0.5));
     w->shapes().push_back(ball);
 
     raytracer::Ray r(raytracer::Point(0, 0, -3), raytracer::Vector(0, -sqrt(2) / 2, sqrt(2) / 2));
@@ -383,7 +407,7 @@ TEST_F(WorldTest, ShadeHit_with_a_reflective_transparent_materia)
     raytracer::Ray r(raytracer::Point(0, 0, -3), raytracer::Vector(0, -sqrt(2) / 2, sqrt(2) / 2));
 
     raytracer::Plane *floor = new raytracer::Plane();
-    floor->transform() = raytracer::Matrix::translation(0, -1, 0);
+    floor->setTransform(raytracer::Matrix4::translation(0, -1, 0));
     floor->material().reflective = 0.5;
     floor->material().transparency = 0.5;
     floor->material().refractiveIndex = 1.5;
@@ -392,7 +416,7 @@ TEST_F(WorldTest, ShadeHit_with_a_reflective_transparent_materia)
     raytracer::Sphere *ball = new raytracer::Sphere();
     ball->material().color() = raytracer::Color(1, 0, 0);
     ball->material().ambient() = 0.5;
-    ball->transform() = raytracer::Matrix::translation(0, -3.5, -0.5);
+    ball->setTransform(raytracer::Matrix4::translation(0, -3.5, -0.5));
     w->shapes().push_back(ball);
 
     raytracer::Intersections xs = {
@@ -404,3 +428,53 @@ TEST_F(WorldTest, ShadeHit_with_a_reflective_transparent_materia)
     EXPECT_TRUE(c == raytracer::Color(0.93391, 0.69643, 0.69243));
     delete w;
 }
+
+// Rendering the default world does not allocate per ray
+TEST_F(WorldTest, Rendering_the_default_world_does_not_allocate_per_ray)
+{
+    raytracer::World *w = raytracer::World::Default();
+    raytracer::Camera c(32, 32, M_PI / 2);
+    c.setTransform(raytracer::Matrix4::viewTransform(raytracer::Point(0, 0, -5), raytracer::Point(0, 0, 0), raytracer::Vector(0, 1, 0)));
+
+    AllocationCounter allocations;
+    double sum = 0;
+    for (int y = 0; y < c.vsize; ++y) {
+        for (int x = 0; x < c.hsize; ++x) {
+            raytracer::Color color = w->colorAt(c.rayForPixel(x, y));
+            sum += color.red() + color.green() + color.blue();
+        }
+    }
+    EXPECT_EQ(allocations.count(), 0);
+    EXPECT_GT(sum, 0);
+    delete w;
+}
+
+// Committing a world bakes group transforms into its shapes
+TEST_F(WorldTest, Committing_a_world_bakes_group_transforms_into_its_shapes)
+{
+    raytracer::World w;
+    w.light() = new raytracer::PointLight(raytracer::Point(-10, 10, -10), raytracer::Color(1, 1, 1));
+    raytracer::Group *outer = new raytracer::Group();
+    outer->setTransform(raytracer::Matrix4::rotationY(M_PI / 2));
+    raytracer::Group *inner = new raytracer::Group();
+    inner->setTransform(raytracer::Matrix4::scaling(1, 2, 3));
+    outer->add(inner);
+    raytracer::Sphere *s = new raytracer::Sphere();
+    s->setTransform(raytracer::Matrix4::translation(5, 0, 0));
+    inner->add(s);
+    w.shapes().push_back(outer);
+    raytracer::Sphere *loose = new raytracer::Sphere();
+    w.shapes().push_back(loose);
+
+    raytracer::Ray r(raytracer::Point(-10, 0.2, 5), raytracer::Vector(1, 0, 0));
+    raytracer::Point p(1.7321, 1.1547, -5.5774);
+    raytracer::Vector expected = s->normalToWorld(raytracer::Vector(0.2, 0.3, 0.5).normalize().asVector());
+    raytracer::Color color = w.colorAt(r);
+
+    w.commit();
+    ASSERT_TRUE(outer->committed() && inner->committed() && s->committed() && loose->committed());
+    ASSERT_TRUE(s->worldToObjectTransform() == raytracer::Matrix4(s->inverseTransform() * inner->inverseTransform() * outer->inverseTransform()));
+    ASSERT_TRUE(s->normalToWorld(raytracer::Vector(0.2, 0.3, 0.5).normalize().asVector()) == expected);
+    ASSERT_TRUE(s->worldToObject(p) == (s->inverseTransform() * inner->inverseTransform() * outer->inverseTransform() * p).asPoint());
+    ASSERT_TRUE(w.colorAt(r) == color);
+}